@@ -22,15 +22,27 @@ set(
   CACHE STRING "The gprof analyze result txt file"
 )
 
+set(
+  GPROF_ANNOTATED_TXT_DST
+  ${CMAKE_BINARY_DIR}/gprof-annotated.txt
+  CACHE STRING "The gprof annotated source result txt file"
+)
+
 message(STATUS "gprof: ${GPROF_EXEC}")
 message(STATUS "gprof analyze dst: ${GPROF_ANALYZE_TXT_DST}")
+message(STATUS "gprof annotated dst: ${GPROF_ANNOTATED_TXT_DST}")
 
 add_custom_target(
   gprof-analyze
-  COMMAND $<TARGET_FILE:${PROJECT_BINARY_NAME}> 
-    && ${GPROF_EXEC} -I${CMAKE_SOURCE_DIR} $<TARGET_FILE:${PROJECT_BINARY_NAME}> 
-       ${CMAKE_BINARY_DIR}/gmon.out > ${GPROF_ANALYZE_TXT_DST}
-  COMMENT "Executing gprof command for the project main binary file. Outputs into the ${GPROF_ANALYZE_TXT_DST}."
-  DEPENDS ${PROJECT_BINARY_NAME}
+  COMMAND $<TARGET_FILE:${PROJECT_BENCH_NAME}> run ${BENCH_CORPUS_DIR}
+    ${BENCH_OUTPUT_DIR} ${BENCH_ITERATIONS}
+  COMMAND ${GPROF_EXEC} -I${CMAKE_SOURCE_DIR}
+    $<TARGET_FILE:${PROJECT_BENCH_NAME}> ${CMAKE_BINARY_DIR}/gmon.out
+    > ${GPROF_ANALYZE_TXT_DST}
+  COMMAND ${GPROF_EXEC} -A -I${CMAKE_SOURCE_DIR}
+    $<TARGET_FILE:${PROJECT_BENCH_NAME}> ${CMAKE_BINARY_DIR}/gmon.out
+    > ${GPROF_ANNOTATED_TXT_DST}
+  COMMENT "Executing gprof command for the benchmark binary over the corpus. Outputs into the ${GPROF_ANALYZE_TXT_DST} and ${GPROF_ANNOTATED_TXT_DST}."
+  DEPENDS bench-corpus
   WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
-)
\ No newline at end of file
+)
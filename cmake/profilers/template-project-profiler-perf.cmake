@@ -0,0 +1,50 @@
+cmake_minimum_required(VERSION 3.13)
+
+if(NOT CMAKE_BUILD_TYPE STREQUAL "Debug"
+   AND NOT CMAKE_BUILD_TYPE STREQUAL "RelWithDebInfo")
+  message(FATAL_ERROR "Profiling is only for the Debug or RelWithDebInfo builds")
+endif()
+
+find_program(PERF_EXEC perf REQUIRED)
+
+# The call graphs are recorded by the frame pointers
+set(EXTRA_COMPILE_OPTIONS
+  ${EXTRA_COMPILE_OPTIONS}
+  -fno-omit-frame-pointer
+)
+
+set(
+  PERF_DATA_DST
+  ${CMAKE_BINARY_DIR}/perf.data
+  CACHE STRING "The perf record raw data file"
+)
+
+set(
+  PERF_REPORT_TXT_DST
+  ${CMAKE_BINARY_DIR}/perf-report.txt
+  CACHE STRING "The perf report result txt file"
+)
+
+set(
+  PERF_ANNOTATED_TXT_DST
+  ${CMAKE_BINARY_DIR}/perf-annotated.txt
+  CACHE STRING "The perf annotate result txt file"
+)
+
+message(STATUS "perf: ${PERF_EXEC}")
+message(STATUS "perf report dst: ${PERF_REPORT_TXT_DST}")
+message(STATUS "perf annotated dst: ${PERF_ANNOTATED_TXT_DST}")
+
+add_custom_target(
+  perf-analyze
+  COMMAND ${PERF_EXEC} record -g -o ${PERF_DATA_DST}
+    $<TARGET_FILE:${PROJECT_BENCH_NAME}> run ${BENCH_CORPUS_DIR}
+    ${BENCH_OUTPUT_DIR} ${BENCH_ITERATIONS}
+  COMMAND ${PERF_EXEC} report --stdio -i ${PERF_DATA_DST}
+    > ${PERF_REPORT_TXT_DST}
+  COMMAND ${PERF_EXEC} annotate --stdio -i ${PERF_DATA_DST}
+    > ${PERF_ANNOTATED_TXT_DST}
+  COMMENT "Executing perf record for the benchmark binary over the corpus. Outputs into the ${PERF_REPORT_TXT_DST} and ${PERF_ANNOTATED_TXT_DST}"
+  DEPENDS bench-corpus
+  WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+)
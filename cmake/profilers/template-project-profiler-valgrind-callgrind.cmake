@@ -5,13 +5,33 @@ if(NOT CMAKE_BUILD_TYPE STREQUAL "Debug")
 endif()
 
 find_program(VALGRIND_EXEC valgrind REQUIRED)
+find_program(CALLGRIND_ANNOTATE_EXEC callgrind_annotate REQUIRED)
+
+set(
+  CALLGRIND_OUT_DST
+  ${CMAKE_BINARY_DIR}/callgrind.out.bench
+  CACHE STRING "The callgrind raw profile output file"
+)
+
+set(
+  CALLGRIND_ANNOTATED_TXT_DST
+  ${CMAKE_BINARY_DIR}/callgrind-annotated.txt
+  CACHE STRING "The callgrind_annotate result txt file"
+)
 
 message(STATUS "valgrind (callgrind): ${VALGRIND_EXEC}")
+message(STATUS "callgrind_annotate: ${CALLGRIND_ANNOTATE_EXEC}")
 
 add_custom_target(
   callgrind
-  COMMAND ${VALGRIND_EXEC} --tool=callgrind $<TARGET_FILE:${PROJECT_BINARY_NAME}>
-  COMMENT "Executing valgrind --tool=callgrind command for the project main binary file. Outputs into the ${CMAKE_BINARY_DIR}/callgrind.out.* files"
-  DEPENDS ${PROJECT_BINARY_NAME}
+  COMMAND ${VALGRIND_EXEC} --tool=callgrind
+    --callgrind-out-file=${CALLGRIND_OUT_DST}
+    $<TARGET_FILE:${PROJECT_BENCH_NAME}> run ${BENCH_CORPUS_DIR}
+    ${BENCH_OUTPUT_DIR} ${BENCH_ITERATIONS}
+  COMMAND ${CALLGRIND_ANNOTATE_EXEC} --auto=yes
+    --include=${CMAKE_SOURCE_DIR} ${CALLGRIND_OUT_DST}
+    > ${CALLGRIND_ANNOTATED_TXT_DST}
+  COMMENT "Executing valgrind --tool=callgrind command for the benchmark binary over the corpus. Outputs into the ${CALLGRIND_OUT_DST} and ${CALLGRIND_ANNOTATED_TXT_DST}"
+  DEPENDS bench-corpus
   WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
 )
@@ -51,3 +51,11 @@ endif()
 if (ENABLE_CALLGRIND)
   include(template-project-profiler-valgrind-callgrind)
 endif()
+
+if (ENABLE_PERF)
+  include(template-project-profiler-perf)
+endif()
+
+if (ENABLE_GPROF OR ENABLE_CALLGRIND OR ENABLE_PERF)
+  set(ENABLE_BENCHMARK ON)
+endif()
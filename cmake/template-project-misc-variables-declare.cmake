@@ -10,6 +10,11 @@ set(
   CACHE STRING "Project main library name and target"
 )
 
+set(
+  PROJECT_BENCH_NAME "${PROJECT_NAME}-bench"
+  CACHE STRING "Project headless benchmark binary name and target"
+)
+
 set(
   QT6_OBJECT_NAME "${PROJECT_NAME}QT6Obj"
   CACHE STRING "Project Qt6 object library name and target"
@@ -176,6 +181,38 @@ option(
   OFF
 )
 
+option(
+  ENABLE_PERF
+  "Set to ON to enable the perf (Linux) application profiler analysis"
+  OFF
+)
+
+option(
+  ENABLE_BENCHMARK
+  "Set to ON to build the headless benchmark binary (forced by the profilers)"
+  OFF
+)
+
+set(
+  BENCH_CORPUS_DIR "${CMAKE_BINARY_DIR}/bench-corpus"
+  CACHE STRING "The generated benchmark BMP corpus directory"
+)
+
+set(
+  BENCH_OUTPUT_DIR "${CMAKE_BINARY_DIR}/bench-output"
+  CACHE STRING "The benchmark barch files output directory"
+)
+
+set(
+  BENCH_CORPUS_SIZE "8 512 512"
+  CACHE STRING "The generated benchmark corpus files count, width and height"
+)
+
+set(
+  BENCH_ITERATIONS "1"
+  CACHE STRING "The benchmark passes count over the whole corpus"
+)
+
 option(
   ENABLE_COMPONENT_TESTS
   "Set to ON value if component tests build and run should be available"
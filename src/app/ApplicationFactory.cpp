@@ -11,6 +11,7 @@
 #include "src/app/CommandLineParser.h"
 #include "src/app/IApplication.h"
 #include "src/log/log.h"
+#include "src/log/trace.h"
 
 namespace app
 {
@@ -103,6 +104,14 @@ int ApplicationFactory::run(int& gargc, char**& gargv)
     LOG_INIT_PATH(custom_log);
   }
 
+  const std::string custom_trace =
+      CommandLineParser::get_custom_tracefile(gargc, gargv);
+
+  if (!custom_trace.empty()) {
+    TRACE_INIT(custom_trace);
+    TRACE_THREAD_NAME("main");
+  }
+
   std::shared_ptr<ApplicationContext> ctx = create_context(gargc, gargv);
 
   assert(ctx != nullptr);
@@ -123,7 +132,13 @@ int ApplicationFactory::run(int& gargc, char**& gargv)
 
   LOGD("Starting the application");
 
-  return app->run(ctx);
+  const int status = app->run(ctx);
+
+  if (!custom_trace.empty() && !TRACE_FLUSH()) {
+    LOGE("Fail to write the trace file " << custom_trace);
+  }
+
+  return status;
 }
 
 int ApplicationFactory::execute(int& gargc, char**& gargv)
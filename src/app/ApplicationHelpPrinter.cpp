@@ -41,6 +41,10 @@ int ApplicationHelpPrinter::run(std::shared_ptr<ApplicationContext> ctx)
             << std::endl
             << CMDParamNames::CWD << " or " << CMDParamNames::CWDW
             << "\t set up current working dir during application start"
+            << std::endl
+            << CMDParamNames::TRACEPATH << " or " << CMDParamNames::TRACEPATHW
+            << "\t write the Chrome trace-event JSON of the conversions "
+               "into the given file"
             << std::endl;
 
   return 0;
@@ -24,6 +24,8 @@ class CMDParamNames
   inline static const std::string VERSION{"-v"};
   inline static const std::string LOGPATHW{"--log-file"};
   inline static const std::string LOGPATH{"-l"};
+  inline static const std::string TRACEPATHW{"--trace-file"};
+  inline static const std::string TRACEPATH{"-t"};
 
   inline static const std::string CWD{"-d"};
   inline static const std::string CWDW{"--cwd"};
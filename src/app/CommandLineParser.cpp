@@ -84,7 +84,9 @@ bool CommandLineParser::parse_arg(std::shared_ptr<ApplicationContext> ctx,
   } else if (param == CMDParamNames::CWD || param == CMDParamNames::CWDW) {
     ctx->startdir = nextParam;
   } else if (param == CMDParamNames::LOGPATHW ||
-             param == CMDParamNames::LOGPATH) {
+             param == CMDParamNames::LOGPATH ||
+             param == CMDParamNames::TRACEPATHW ||
+             param == CMDParamNames::TRACEPATH) {
     // skipping already parsed cmd params
   } else {
     ctx->print_help_and_exit = true;
@@ -105,8 +107,9 @@ const std::set<std::string>& CommandLineParser::get_params_requiring_data()
   // Place here command line parameters that are requiring
   // some data after it.
   static const std::set<std::string> requireNext{
-      CMDParamNames::LOGPATHW, CMDParamNames::LOGPATH, CMDParamNames::CWD,
-      CMDParamNames::CWDW};
+      CMDParamNames::LOGPATHW,   CMDParamNames::LOGPATH,
+      CMDParamNames::TRACEPATHW, CMDParamNames::TRACEPATH,
+      CMDParamNames::CWD,        CMDParamNames::CWDW};
 
   return requireNext;
 }
@@ -135,4 +138,20 @@ std::string CommandLineParser::get_custom_logfile(const int& gargc,
   return logf;
 }
 
+std::string CommandLineParser::get_custom_tracefile(const int& gargc,
+                                                    char** const& gargv)
+{
+  std::string tracef;
+
+  for (int iter = 1; iter < gargc; ++iter) {
+    if ((gargv[iter] == CMDParamNames::TRACEPATHW ||
+         gargv[iter] == CMDParamNames::TRACEPATH) &&
+        (iter + 1) < gargc) {
+      tracef = gargv[iter + 1];
+    }
+  }
+
+  return tracef;
+}
+
 }  // namespace app
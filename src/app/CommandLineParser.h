@@ -43,6 +43,21 @@ class CommandLineParser
    */
   static std::string get_custom_logfile(const int& gargc, char** const& gargv);
 
+  /**
+   * @brief Method that searches through the cmd params for
+   * a Chrome trace-event JSON file path if any. Intended to be used at
+   * the ApplicationFactory app starter methods which are initing the
+   * tracing subsystem.
+   *
+   * @param gargc Count of a given command line parameters.
+   * @param gargv An array of a given command line parameters.
+   *
+   * @return Returns the trace file path or empty string if tracing is not
+   * requested.
+   */
+  static std::string get_custom_tracefile(const int& gargc,
+                                          char** const& gargv);
+
  protected:
   /**
    * @brief Parse single argument with optional data provided next to it.
@@ -37,6 +37,19 @@ class CommandLineParser
 
     return {};
   }
+
+  inline static std::function<std::string(const int&, char** const&)>
+      mock_get_custom_tracefile;
+
+  static std::string get_custom_tracefile(const int& gargc,
+                                          char** const& gargv)
+  {
+    if (mock_get_custom_tracefile != nullptr) {
+      return mock_get_custom_tracefile(gargc, gargv);
+    }
+
+    return {};
+  }
 };
 
 }  // namespace app
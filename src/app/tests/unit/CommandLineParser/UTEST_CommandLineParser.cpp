@@ -121,3 +121,25 @@ TEST_F(UTEST_CommandLineParser, unknown_flag)
   EXPECT_FALSE(appctx->print_version_and_exit);
   EXPECT_TRUE(appctx->errors.empty());
 }
+
+TEST_F(UTEST_CommandLineParser, trace_file_found)
+{
+  static std::string binaryName{"binaryName"};
+  static std::string traceFlag{"--trace-file"};
+  static std::string tracePath{"/tmp/trace.json"};
+
+  static char* customArgv[] = {binaryName.data(), traceFlag.data(),
+                               tracePath.data()};
+
+  argc = 3;
+  argv = customArgv;
+
+  EXPECT_CALL(*appctx, push_error(_)).Times(0);
+
+  EXPECT_TRUE(parser->parse_args(appctx));
+
+  EXPECT_EQ(CommandLineParser::get_custom_tracefile(argc, argv), tracePath);
+  EXPECT_TRUE(CommandLineParser::get_custom_logfile(argc, argv).empty());
+  EXPECT_FALSE(appctx->print_help_and_exit);
+  EXPECT_TRUE(appctx->errors.empty());
+}
@@ -0,0 +1,180 @@
+#include "src/bench/BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "src/log/log.h"
+
+namespace bench
+{
+
+namespace fs = std::filesystem;
+
+BenchmarkRunner::BenchmarkRunner(barchclib0::ILibPtr nlib)
+    : mlib{std::move(nlib)}
+{
+}
+
+const BenchmarkRunner::Totals& BenchmarkRunner::totals() const
+{
+  return mtotals;
+}
+
+uint64_t BenchmarkRunner::elapsed(const clock::time_point& from)
+{
+  using namespace std::chrono;
+
+  return static_cast<uint64_t>(
+      duration_cast<microseconds>(clock::now() - from).count());
+}
+
+std::vector<fs::path> BenchmarkRunner::list_corpus(const fs::path& corpus)
+{
+  std::vector<fs::path> files;
+
+  try {
+    for (const auto& entry : fs::directory_iterator{corpus}) {
+      if (entry.is_regular_file() && entry.path().extension() == ".bmp") {
+        files.emplace_back(entry.path());
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    LOGE("Fail to list the corpus directory " << corpus << ": " << e.what());
+    return {};
+  }
+
+  // directory order is filesystem specific, keep runs repeatable
+  std::sort(files.begin(), files.end());
+
+  return files;
+}
+
+bool BenchmarkRunner::run(const fs::path& corpus, const fs::path& output,
+                          const size_t& iterations)
+{
+  if (mlib == nullptr) {
+    LOGE("No library instance provided");
+    return false;
+  }
+
+  const auto files = list_corpus(corpus);
+
+  if (files.empty()) {
+    LOGE("No BMP files found in the corpus " << corpus);
+    return false;
+  }
+
+  try {
+    fs::create_directories(output);
+  }
+  catch (const std::exception& e) {
+    LOGE("Fail to create the output directory " << output << ": " << e.what());
+    return false;
+  }
+
+  for (size_t iter = 0U; iter < iterations; ++iter) {
+    for (const auto& file : files) {
+      if (!round_trip(file, output)) {
+        LOGE("Round-trip failure for " << file);
+        ++mtotals.failures;
+      }
+
+      ++mtotals.files;
+    }
+  }
+
+  return mtotals.failures == 0U;
+}
+
+bool BenchmarkRunner::round_trip(const fs::path& bmpPath,
+                                 const fs::path& output)
+{
+  auto start = clock::now();
+  auto bmp = mlib->read(bmpPath);
+  mtotals.read_bmp += elapsed(start);
+
+  if (bmp == nullptr) {
+    return false;
+  }
+
+  start = clock::now();
+  auto barch = mlib->bmp_to_barch(bmp);
+  mtotals.encode += elapsed(start);
+
+  if (barch == nullptr) {
+    return false;
+  }
+
+  const fs::path barchPath = output / (bmpPath.stem().string() + ".barch");
+
+  barch->filepath(barchPath);
+
+  start = clock::now();
+  const bool written = mlib->write(barch);
+  mtotals.write += elapsed(start);
+
+  if (!written) {
+    return false;
+  }
+
+  start = clock::now();
+  auto readBarch = mlib->read(barchPath);
+  mtotals.read_barch += elapsed(start);
+
+  if (readBarch == nullptr) {
+    return false;
+  }
+
+  start = clock::now();
+  auto decoded = mlib->barch_to_bmp(readBarch);
+  mtotals.decode += elapsed(start);
+
+  if (decoded == nullptr) {
+    return false;
+  }
+
+  mtotals.bmp_bytes += bmp->data().size();
+  mtotals.barch_bytes += fs::file_size(barchPath);
+
+  if (decoded->data() != bmp->data()) {
+    LOGE("Decoded pixels mismatch the source " << bmpPath);
+    return false;
+  }
+
+  return true;
+}
+
+void BenchmarkRunner::report(std::ostream& os) const
+{
+  static constexpr const double usInMs = 1000.0;
+
+  const auto line = [&os](const char* const name, const uint64_t& us) {
+    os << std::left << std::setw(12) << name << std::right << std::setw(12)
+       << std::fixed << std::setprecision(3)
+       << static_cast<double>(us) / usInMs << " ms\n";
+  };
+
+  os << "files:      " << mtotals.files << " (failures: " << mtotals.failures
+     << ")\n";
+  line("read bmp", mtotals.read_bmp);
+  line("encode", mtotals.encode);
+  line("write", mtotals.write);
+  line("read barch", mtotals.read_barch);
+  line("decode", mtotals.decode);
+
+  if (mtotals.barch_bytes != 0U) {
+    os << "ratio:      " << std::setprecision(3)
+       << static_cast<double>(mtotals.bmp_bytes) /
+              static_cast<double>(mtotals.barch_bytes)
+       << "\n";
+  }
+}
+
+}  // namespace bench
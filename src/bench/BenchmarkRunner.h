@@ -0,0 +1,74 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BENCHMARKRUNNER_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BENCHMARKRUNNER_CLASS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+#include "ILib.h"
+
+namespace bench
+{
+
+/**
+ * @brief Runs the library round-trip (read, encode, write, read, decode)
+ * over every BMP file of the corpus directory. No UI involved, so the
+ * profilers only see the library hot paths.
+ */
+class BenchmarkRunner
+{
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Accumulated stage timings in the microseconds.
+   */
+  struct Totals
+  {
+    uint64_t read_bmp{0U};
+    uint64_t encode{0U};
+    uint64_t write{0U};
+    uint64_t read_barch{0U};
+    uint64_t decode{0U};
+    uint64_t bmp_bytes{0U};
+    uint64_t barch_bytes{0U};
+    size_t files{0U};
+    size_t failures{0U};
+  };
+
+  virtual ~BenchmarkRunner() = default;
+  explicit BenchmarkRunner(barchclib0::ILibPtr nlib);
+
+  /**
+   * @brief Processes all the *.bmp files of the corpus directory the given
+   * times and stores the barch files into the output directory.
+   *
+   * @return Returns false if no files found or any round-trip fails.
+   */
+  virtual bool run(const std::filesystem::path& corpus,
+                   const std::filesystem::path& output,
+                   const size_t& iterations);
+
+  const Totals& totals() const;
+
+  void report(std::ostream& os) const;
+
+ private:
+  bool round_trip(const std::filesystem::path& bmpPath,
+                  const std::filesystem::path& output);
+
+  static std::vector<std::filesystem::path> list_corpus(
+      const std::filesystem::path& corpus);
+
+  static uint64_t elapsed(const clock::time_point& from);
+
+  barchclib0::ILibPtr mlib;
+  Totals mtotals;
+};
+
+}  // namespace bench
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BENCHMARKRUNNER_CLASS_H
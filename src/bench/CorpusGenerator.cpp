@@ -0,0 +1,236 @@
+#include "src/bench/CorpusGenerator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/lib/libmain/readers/BMP.h"
+#include "src/log/log.h"
+
+namespace bench
+{
+
+namespace
+{
+constexpr const unsigned char white = 255U;
+constexpr const unsigned char black = 0U;
+constexpr const uint16_t bmp_magic = 0x4D42;
+constexpr const uint16_t bmp_bits = 8U;
+constexpr const uint32_t palette_size = 256U;
+constexpr const size_t margin_div = 10U;
+constexpr const size_t line_height = 24U;
+constexpr const size_t glyph_height = 14U;
+constexpr const size_t rule_step = 32U;
+}  // namespace
+
+CorpusGenerator::CorpusGenerator(const uint32_t& seed) : mrand{seed} {}
+
+size_t CorpusGenerator::next(const size_t& range)
+{
+  if (range == 0U) {
+    return 0U;
+  }
+
+  const size_t value = mrand();
+
+  return value % range;
+}
+
+std::string CorpusGenerator::kind_name(const PageKind& kind)
+{
+  switch (kind) {
+    case PageKind::document:
+      return "document";
+    case PageKind::lineart:
+      return "lineart";
+    case PageKind::photo:
+      return "photo";
+    case PageKind::mixed:
+      return "mixed";
+  }
+
+  return "unknown";
+}
+
+bool CorpusGenerator::generate(const std::filesystem::path& dir,
+                               const size_t& count, const size_t& width,
+                               const size_t& height)
+{
+  if (width == 0U || height == 0U) {
+    LOGE("Invalid corpus image size " << width << "x" << height);
+    return false;
+  }
+
+  try {
+    std::filesystem::create_directories(dir);
+  }
+  catch (const std::exception& e) {
+    LOGE("Fail to create the corpus directory " << dir << ": " << e.what());
+    return false;
+  }
+
+  for (size_t iter = 0U; iter < count; ++iter) {
+    const auto kind = static_cast<PageKind>(iter % kinds_count);
+    const std::string name =
+        "corpus-" + std::to_string(iter) + "-" + kind_name(kind) + ".bmp";
+
+    if (!write_bmp(dir / name, page(kind, width, height), width, height)) {
+      LOGE("Fail to write the corpus file " << name);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+CorpusGenerator::pixels CorpusGenerator::page(const PageKind& kind,
+                                              const size_t& width,
+                                              const size_t& height)
+{
+  pixels data(width * height, white);
+
+  switch (kind) {
+    case PageKind::document:
+      fill_document(data, width, height, 0U, height);
+      break;
+    case PageKind::lineart:
+      fill_lineart(data, width, height);
+      break;
+    case PageKind::photo:
+      fill_photo(data, width, 0U, height);
+      break;
+    case PageKind::mixed:
+      fill_document(data, width, height, 0U, height / 2U);
+      fill_photo(data, width, height / 2U, height);
+      break;
+  }
+
+  return data;
+}
+
+void CorpusGenerator::fill_document(pixels& data, const size_t& width,
+                                    const size_t& height, const size_t& fromRow,
+                                    const size_t& toRow)
+{
+  const size_t margin = width / margin_div;
+  const size_t top = std::max(fromRow, height / margin_div);
+  const size_t bottom = std::min(toRow, height - height / margin_div);
+
+  for (size_t row = top; row + glyph_height < bottom; row += line_height) {
+    size_t col = margin;
+    const size_t lineEnd = width - margin - next(width / 4U + 1U);
+
+    while (col < lineEnd) {
+      const size_t glyph = 4U + next(12U);
+      const size_t gap = 2U + next(6U);
+
+      for (size_t grow = row; grow < row + glyph_height; ++grow) {
+        for (size_t gcol = col; gcol < col + glyph && gcol < lineEnd; ++gcol) {
+          // mostly solid ink with the anti-aliased gray edges
+          const bool edge = gcol == col || gcol + 1U == col + glyph;
+          data[grow * width + gcol] =
+              edge ? static_cast<unsigned char>(64U + next(128U)) : black;
+        }
+      }
+
+      col += glyph + gap;
+    }
+  }
+}
+
+void CorpusGenerator::fill_lineart(pixels& data, const size_t& width,
+                                   const size_t& height)
+{
+  for (size_t row = 0U; row < height; ++row) {
+    const bool ruled = row % rule_step == 0U;
+
+    for (size_t col = 0U; col < width; ++col) {
+      const bool framed = col % (rule_step * 4U) == 0U;
+
+      if (ruled || framed) {
+        data[row * width + col] = black;
+      }
+    }
+  }
+}
+
+void CorpusGenerator::fill_photo(pixels& data, const size_t& width,
+                                 const size_t& fromRow, const size_t& toRow)
+{
+  static constexpr const size_t noise = 24U;
+
+  for (size_t row = fromRow; row < toRow; ++row) {
+    for (size_t col = 0U; col < width; ++col) {
+      const size_t base = (row + col) % (white - noise);
+
+      data[row * width + col] = static_cast<unsigned char>(base + next(noise));
+    }
+  }
+}
+
+bool CorpusGenerator::write_bmp(const std::filesystem::path& path,
+                                const pixels& data, const size_t& width,
+                                const size_t& height)
+{
+  using barchclib0::readers::BITMAPFILEHEADER;
+  using barchclib0::readers::BITMAPINFOHEADER;
+
+  if (data.size() != width * height) {
+    LOGE("Pixels buffer mismatches the image size");
+    return false;
+  }
+
+  const size_t rowSize = ((bmp_bits * width + 31U) / 32U) * 4U;
+  const uint32_t paletteBytes = palette_size * 4U;
+  const uint32_t offset = static_cast<uint32_t>(
+      sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER) + paletteBytes);
+
+  BITMAPFILEHEADER fileHeader{};
+  fileHeader.bfType = bmp_magic;
+  fileHeader.bfOffBits = offset;
+  fileHeader.bfSize = static_cast<uint32_t>(offset + rowSize * height);
+
+  BITMAPINFOHEADER infoHeader{};
+  infoHeader.biSize = sizeof(BITMAPINFOHEADER);
+  infoHeader.biWidth = static_cast<int32_t>(width);
+  infoHeader.biHeight = static_cast<int32_t>(height);
+  infoHeader.biPlanes = 1U;
+  infoHeader.biBitCount = bmp_bits;
+  infoHeader.biSizeImage = static_cast<uint32_t>(rowSize * height);
+  infoHeader.biClrUsed = palette_size;
+
+  std::ofstream f{path, std::ofstream::binary | std::ofstream::trunc};
+
+  if (!f.is_open()) {
+    LOGE("Fail to open " << path);
+    return false;
+  }
+
+  f.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+  f.write(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader));
+
+  for (uint32_t color = 0U; color < palette_size; ++color) {
+    const unsigned char c = static_cast<unsigned char>(color);
+    const unsigned char entry[] = {c, c, c, 0U};
+    f.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+  }
+
+  pixels padded(rowSize, black);
+
+  // BMP rows are stored bottom-up
+  for (size_t row = height; row > 0U; --row) {
+    std::copy_n(data.begin() + static_cast<std::ptrdiff_t>((row - 1U) * width),
+                width, padded.begin());
+    f.write(reinterpret_cast<const char*>(padded.data()),
+            static_cast<std::streamsize>(padded.size()));
+  }
+
+  return static_cast<bool>(f);
+}
+
+}  // namespace bench
@@ -0,0 +1,74 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CORPUSGENERATOR_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CORPUSGENERATOR_CLASS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * @brief Generates the deterministic synthetic corpus of the 8-bit grayscale
+ * BMP files for the benchmark and the profiling runs. Same seed and sizes
+ * always produce byte-identical files so profiles are repeatable.
+ */
+class CorpusGenerator
+{
+ public:
+  using pixels = std::vector<unsigned char>;
+
+  /**
+   * @brief The kinds of the generated pages. Each kind stresses a different
+   * codec path: blank margins, repeated rows, incompressible noise.
+   */
+  enum class PageKind
+  {
+    document,
+    lineart,
+    photo,
+    mixed,
+  };
+
+  inline static constexpr const size_t kinds_count = 4U;
+  inline static constexpr const uint32_t default_seed = 20250606U;
+
+  virtual ~CorpusGenerator() = default;
+  explicit CorpusGenerator(const uint32_t& seed = default_seed);
+
+  /**
+   * @brief Writes count BMP files into the given directory cycling through
+   * all of the page kinds.
+   *
+   * @return Returns false if any file fails to be written.
+   */
+  virtual bool generate(const std::filesystem::path& dir, const size_t& count,
+                        const size_t& width, const size_t& height);
+
+  /// @brief Generates the top-down page pixels of the given kind.
+  pixels page(const PageKind& kind, const size_t& width, const size_t& height);
+
+  static bool write_bmp(const std::filesystem::path& path, const pixels& data,
+                        const size_t& width, const size_t& height);
+
+  static std::string kind_name(const PageKind& kind);
+
+ private:
+  void fill_document(pixels& data, const size_t& width, const size_t& height,
+                     const size_t& fromRow, const size_t& toRow);
+  void fill_lineart(pixels& data, const size_t& width, const size_t& height);
+  void fill_photo(pixels& data, const size_t& width, const size_t& fromRow,
+                  const size_t& toRow);
+
+  /// @brief Platform independent random value in [0, range).
+  size_t next(const size_t& range);
+
+  std::mt19937 mrand;
+};
+
+}  // namespace bench
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CORPUSGENERATOR_CLASS_H
@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "LibraryFacade.h"
+#include "src/bench/BenchmarkRunner.h"
+#include "src/bench/CorpusGenerator.h"
+#include "src/log/log.h"
+
+namespace
+{
+
+constexpr const size_t default_count = 8U;
+constexpr const size_t default_width = 512U;
+constexpr const size_t default_height = 512U;
+constexpr const size_t default_iterations = 1U;
+constexpr const size_t default_decode_threads = 1U;
+
+void print_usage(const char* const self)
+{
+  std::cout << "Usage:\n"
+            << "  " << self << " generate <dir> [count] [width] [height]\n"
+            << "  " << self
+            << " run <corpus dir> <output dir> [iterations] [decode threads]\n";
+}
+
+size_t arg_or(const int argc, char** argv, const int idx,
+              const size_t& fallback)
+{
+  if (idx >= argc) {
+    return fallback;
+  }
+
+  return std::stoul(argv[idx]);
+}
+
+}  // namespace
+
+/**
+ * @brief The headless benchmark workload for the profilers. Generates the
+ * deterministic corpus or runs the library round-trip over it.
+ */
+int main(int argc, char** argv)
+{
+  static constexpr const int minArgs = 3;
+
+  LOG_INIT("", simple_logger::SimpleLogger::LVL_ERROR, true);
+
+  if (argc < minArgs) {
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const std::string command = argv[1];
+
+  try {
+    if (command == "generate") {
+      bench::CorpusGenerator gen;
+
+      return gen.generate(argv[2], arg_or(argc, argv, 3, default_count),
+                          arg_or(argc, argv, 4, default_width),
+                          arg_or(argc, argv, 5, default_height))
+                 ? EXIT_SUCCESS
+                 : EXIT_FAILURE;
+    }
+
+    if (command == "run" && argc > minArgs) {
+      barchclib0::LibraryFacade facade;
+      auto lib = facade.create();
+
+      if (lib != nullptr) {
+        lib->decode_threads(arg_or(argc, argv, 5, default_decode_threads));
+      }
+
+      bench::BenchmarkRunner runner{std::move(lib)};
+
+      const bool success = runner.run(
+          argv[2], argv[3], arg_or(argc, argv, 4, default_iterations));
+
+      runner.report(std::cout);
+
+      return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  catch (const std::exception& e) {
+    LOGE("Benchmark failure: " << e.what());
+    return EXIT_FAILURE;
+  }
+
+  print_usage(argv[0]);
+
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,41 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BARCHFORMAT_DECLARATIONS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BARCHFORMAT_DECLARATIONS_H
+
+namespace barchclib0
+{
+
+/**
+ * @brief The barch file format variants. The reader accepts all of them,
+ * the variant of the written file is chosen at the encoding.
+ */
+enum class BarchFormat
+{
+  /// @brief The 4 pixel group codes only
+  ba000,
+  /// @brief The BA000 codes plus the run codes of the long uniform spans
+  ba001,
+  /**
+   * @brief The BA001 codes with the 2 bit rows table: the whole white or
+   * black rows are marked in the table and carry no payload
+   */
+  ba002,
+  /**
+   * @brief The BA002 with the 4 bit rows table: a row identical to one of
+   * the 8 rows above it is stored as the reference without payload
+   */
+  ba003,
+  /**
+   * @brief The BA003 where a row may be coded as the residual against the
+   * row above: the equal pixels turn into the whites
+   */
+  ba004,
+  /**
+   * @brief The BA004 with the pixels of the as-is groups coded with the
+   * per-image canonical Huffman code stored in the header
+   */
+  ba005
+};
+
+}  // namespace barchclib0
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BARCHFORMAT_DECLARATIONS_H
@@ -0,0 +1,92 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCH_DECLARATIONS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCH_DECLARATIONS_H
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "EncoderPreset.h"
+
+namespace barchclib0
+{
+
+/**
+ * @brief The single batch conversion job. The input file extension defines
+ * the direction: BMP files are encoded into the barch and barch files are
+ * decoded into the BMP.
+ */
+struct BatchItem
+{
+  std::filesystem::path input;
+  std::filesystem::path output;
+};
+
+/**
+ * @brief The per-file results delivery order.
+ */
+enum class BatchOrder
+{
+  /// @brief Results are delivered in the same order as the items given
+  input,
+  /// @brief Results are delivered as soon as the files are written
+  completion,
+};
+
+enum class BatchStatus
+{
+  success,
+  failed,
+  /// @brief The item was not processed due to the fail-fast stop
+  skipped,
+};
+
+/**
+ * @brief The single batch item processing result.
+ */
+struct BatchResult
+{
+  /// @brief The item index in the given batch items list
+  size_t index{0U};
+  std::filesystem::path input;
+  std::filesystem::path output;
+  BatchStatus status{BatchStatus::skipped};
+  /// @brief The failure description, empty on success
+  std::string error;
+  /**
+   * @brief The largest pixel change of the lossy quantization of the encoded
+   * file, zero for the lossless encoding and the decoding
+   */
+  unsigned int quantization_error{0U};
+};
+
+/**
+ * @brief The batch conversion options.
+ */
+struct BatchOptions
+{
+  /**
+   * @brief The codec workers count. Zero means the hardware concurrency. The
+   * workers share the file and the row-range tasks of the large images.
+   */
+  size_t threads{0U};
+  BatchOrder order{BatchOrder::input};
+  /// @brief Stop reading and converting new files after the first failure
+  bool fail_fast{false};
+  /// @brief The encoder profile of the batch, the library settings if unset
+  std::optional<EncoderPreset> preset;
+  /**
+   * @brief Optional per-file progress callback. Called from the library
+   * internal thread in the results delivery order.
+   */
+  std::function<void(const BatchResult&)> on_result;
+};
+
+using BatchItems = std::vector<BatchItem>;
+using BatchResults = std::vector<BatchResult>;
+
+}  // namespace barchclib0
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCH_DECLARATIONS_H
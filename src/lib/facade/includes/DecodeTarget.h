@@ -0,0 +1,47 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_DECODETARGET_DECLARATIONS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_DECODETARGET_DECLARATIONS_H
+
+#include <cstddef>
+
+namespace barchclib0
+{
+
+/// @brief The order the image rows are laid out in the memory
+enum class RowOrder
+{
+  /// @brief The first image row at the buffer start, like the QImage
+  top_down,
+  /// @brief The last image row at the buffer start, like the BMP file
+  bottom_up
+};
+
+/**
+ * @brief The caller owned buffer the barch image is decoded straight into.
+ * The row starts are stride bytes apart; the padding bytes past the image
+ * width are left untouched.
+ */
+struct DecodeTarget
+{
+  unsigned char* pixels{nullptr};
+  /// @brief The buffer size in bytes, validated against the image size
+  size_t size{0U};
+  /// @brief The distance between the row starts, the image width at least
+  size_t stride{0U};
+  RowOrder order{RowOrder::top_down};
+};
+
+/**
+ * @brief The rectangle of the image to decode: the rows range and the
+ * columns window. The zero rows or cols count means up to the image end.
+ */
+struct DecodeRegion
+{
+  size_t row{0U};
+  size_t rows{0U};
+  size_t col{0U};
+  size_t cols{0U};
+};
+
+}  // namespace barchclib0
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_DECODETARGET_DECLARATIONS_H
@@ -0,0 +1,29 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_ENCODERPRESET_DECLARATIONS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_ENCODERPRESET_DECLARATIONS_H
+
+namespace barchclib0
+{
+
+/**
+ * @brief The encoder profiles trading the encoding speed for the ratio.
+ * Each one sets the format variant and the per-row compression decision.
+ */
+enum class EncoderPreset
+{
+  /**
+   * @brief The BA000 rows compressed by the runs count rule, no exact cost
+   * evaluation
+   */
+  fast,
+  /// @brief The BA000 rows compressed only when they get smaller, the default
+  balanced,
+  /**
+   * @brief The BA005 variant with the exact cost decisions: the long runs,
+   * the row references, the prediction and the entropy coding
+   */
+  max_ratio
+};
+
+}  // namespace barchclib0
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_ENCODERPRESET_DECLARATIONS_H
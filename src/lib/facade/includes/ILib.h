@@ -1,10 +1,18 @@
 #ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_ILIB_CLASS_H
 #define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_ILIB_CLASS_H
 
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
 
+#include "BarchFormat.h"
+#include "Batch.h"
+#include "DecodeTarget.h"
+#include "EncoderPreset.h"
 #include "IBarchImage.h"
+#include "Quantization.h"
 
 namespace barchclib0
 {
@@ -13,6 +21,8 @@ class ILib
 {
  public:
   using ILibPtr = std::shared_ptr<ILib>;
+  using ImageCallback = std::function<void(IBarchImagePtr)>;
+  using WriteCallback = std::function<void(bool)>;
 
   virtual ~ILib() = default;
   ILib() = default;
@@ -23,12 +33,126 @@ class ILib
   /// @brief Converts the given barch file IBarchImage instance into the BMP
   virtual IBarchImagePtr barch_to_bmp(IBarchImagePtr barch) = 0;
 
+  /**
+   * @brief Decodes the given barch file IBarchImage instance straight into
+   * the caller owned buffer, e.g. the QImage bits or the mapped BMP file
+   * pixels, without the intermediate BMP image
+   */
+  virtual bool barch_to_buffer(IBarchImagePtr barch,
+                               const DecodeTarget& target) = 0;
+
+  /**
+   * @brief Decodes only the region of the given barch image into the caller
+   * owned buffer: the rows outside of it are skipped, unless the region
+   * rows repeat or predict from them, and each row stops past the region
+   * columns
+   */
+  virtual bool barch_to_buffer(IBarchImagePtr barch,
+                               const DecodeTarget& target,
+                               const DecodeRegion& region) = 0;
+
+  /**
+   * @brief Decodes the 1/2, 1/4 or 1/8 scale preview of the given barch
+   * file IBarchImage instance: every scale-th pixel of every scale-th row.
+   * Much cheaper than the full decoding, the other rows are mostly skipped.
+   */
+  virtual IBarchImagePtr barch_to_thumbnail(IBarchImagePtr barch,
+                                            const size_t& scale) = 0;
+
   /// @brief Tries to read image by given filepath. BMP and barch only!
   virtual IBarchImagePtr read(const std::filesystem::path& imagePath) = 0;
 
-  /// @brief Tries to write barch data into given file. Barch only!
+  /// @brief Tries to write image data into it's file path. BMP and barch only!
   virtual bool write(IBarchImagePtr barch) = 0;
 
+  /**
+   * @brief Reads the preview embedded into the barch file, see the
+   * thumbnail_side method. Only the few kilobytes at the start of the file
+   * are read, nothing is decoded. Returns nullptr for the files without it.
+   */
+  virtual IBarchImagePtr read_thumbnail(
+      const std::filesystem::path& imagePath) = 0;
+
+  /**
+   * @brief Converts the list of files with the internal parallel pipeline:
+   * reading, encoding or decoding and writing stages run simultaneously.
+   * BMP inputs are encoded into the barch and barch inputs are decoded into
+   * the BMP.
+   *
+   * @return Returns the per-file results in the options defined order.
+   */
+  virtual BatchResults convert_batch(const BatchItems& items,
+                                     const BatchOptions& options) = 0;
+
+  /**
+   * @brief The asynchronous variants of the read, bmp_to_barch, barch_to_bmp
+   * and write methods. Run on the library owned executor, see the
+   * executor_threads method. The future variants deliver the same result as
+   * the synchronous method. The callback variants call the given callback
+   * from the executor thread, so the next stage may be chained from it
+   * without blocking any thread. The callback is always called exactly
+   * once, even if the operation throws: with nullptr for the image
+   * callbacks and false for the write callbacks on any failure.
+   */
+  virtual std::future<IBarchImagePtr> read_async(
+      const std::filesystem::path& imagePath) = 0;
+  virtual void read_async(const std::filesystem::path& imagePath,
+                          ImageCallback done) = 0;
+
+  virtual std::future<IBarchImagePtr> bmp_to_barch_async(
+      IBarchImagePtr bmp) = 0;
+  virtual void bmp_to_barch_async(IBarchImagePtr bmp, ImageCallback done) = 0;
+
+  virtual std::future<IBarchImagePtr> barch_to_bmp_async(
+      IBarchImagePtr barch) = 0;
+  virtual void barch_to_bmp_async(IBarchImagePtr barch,
+                                  ImageCallback done) = 0;
+
+  virtual std::future<bool> write_async(IBarchImagePtr image) = 0;
+  virtual void write_async(IBarchImagePtr image, WriteCallback done) = 0;
+
+  /**
+   * @brief Sets the library executor workers count. Zero (default) means the
+   * hardware concurrency. If the executor is already running it finishes
+   * the queued operations first and the new one is started on demand.
+   */
+  virtual void executor_threads(const size_t& threads) = 0;
+
+  /**
+   * @brief Sets the format variant the bmp_to_barch produces, BA000 by
+   * default. The reading accepts both variants regardless of it.
+   */
+  virtual void barch_format(const BarchFormat& nformat) = 0;
+
+  /**
+   * @brief Sets the near-white and near-black snapping of the bmp_to_barch,
+   * lossless by default. The invalid thresholds are ignored. The largest
+   * pixel change introduced is reported by the quantization_error method
+   * of the produced image and by the batch results.
+   */
+  virtual void quantization(const Quantization& nquantization) = 0;
+
+  /**
+   * @brief Sets the format variant and the compression decision of the
+   * bmp_to_barch by the profile, the balanced by default. The later
+   * barch_format call overrides the variant of the profile.
+   */
+  virtual void encoder_preset(const EncoderPreset& npreset) = 0;
+
+  /**
+   * @brief Sets the workers count the barch_to_bmp decodes the rows of a
+   * single image with. One (default) decodes on the calling thread, zero
+   * means the hardware concurrency. The pixels are the same for any count.
+   */
+  virtual void decode_threads(const size_t& threads) = 0;
+
+  /**
+   * @brief Sets the longest side of the grayscale preview the bmp_to_barch
+   * embeds into the image and the write stores in the file, up to 255.
+   * Zero (default) embeds none.
+   */
+  virtual void thumbnail_side(const size_t& side) = 0;
+
   /// @brief duplicate the object
   virtual ILibPtr duplicate() = 0;
 
@@ -0,0 +1,28 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_QUANTIZATION_DECLARATIONS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_QUANTIZATION_DECLARATIONS_H
+
+namespace barchclib0
+{
+
+/**
+ * @brief The opt-in lossy encoding mode: the near-white and the near-black
+ * pixels are snapped to the white and the black before the grouping, so
+ * the scanner noise does not break the white and black groups. The default
+ * thresholds keep the encoding lossless.
+ */
+struct Quantization
+{
+  /// @brief The pixels this bright and brighter are encoded as the white
+  unsigned char whites_from{255U};
+  /// @brief The pixels this dark and darker are encoded as the black
+  unsigned char blacks_to{0U};
+
+  bool lossless() const { return whites_from == 255U && blacks_to == 0U; }
+
+  /// @brief The white and black ranges must not overlap
+  bool valid() const { return blacks_to < whites_from; }
+};
+
+}  // namespace barchclib0
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_QUANTIZATION_DECLARATIONS_H
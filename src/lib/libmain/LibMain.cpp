@@ -1,21 +1,31 @@
 #include "src/lib/libmain/LibMain.h"
 
 #include <cassert>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <utility>
 
+#include "src/lib/libmain/batch/BatchConverter.h"
 #include "src/lib/libmain/converters/BMP2BarchConverter0.h"
 #include "src/lib/libmain/converters/BMPAndBarchConverter0Base.h"
 #include "src/lib/libmain/converters/Barch2BMPConverter0.h"
 #include "src/lib/libmain/readers/BMPReader.h"
 #include "src/lib/libmain/readers/BarchReader0.h"
+#include "src/lib/libmain/writers/BMPWriter.h"
 #include "src/lib/libmain/writers/BarchWriter0.h"
 #include "src/log/log.h"
+#include "src/log/trace.h"
 
 namespace lib0impl
 {
 
+LibMain::LibMain() { apply_pool(); }
+
 IBarchImagePtr LibMain::bmp_to_barch(IBarchImagePtr bmp)
 {
+  TRACE_SPAN("codec", "LibMain::bmp_to_barch");
+
   BMPImagePtr realbmp = std::dynamic_pointer_cast<BMPImage>(bmp);
 
   if (realbmp == nullptr) {
@@ -23,11 +33,9 @@ IBarchImagePtr LibMain::bmp_to_barch(IBarchImagePtr bmp)
     return {};
   }
 
-  auto converter = barchclib0::converters::BMP2BarchConverter0::create();
-
-  assert(converter != nullptr);
+  assert(mencoder != nullptr);
 
-  auto barch = converter->convert(realbmp);
+  auto barch = mencoder->convert(realbmp);
 
   if (barch == nullptr) {
     LOGE("Fail to convert into the barch");
@@ -39,6 +47,8 @@ IBarchImagePtr LibMain::bmp_to_barch(IBarchImagePtr bmp)
 
 IBarchImagePtr LibMain::barch_to_bmp(IBarchImagePtr barch)
 {
+  TRACE_SPAN("codec", "LibMain::barch_to_bmp");
+
   BarchImagePtr realb = std::dynamic_pointer_cast<BarchImage>(barch);
 
   if (realb == nullptr) {
@@ -46,11 +56,9 @@ IBarchImagePtr LibMain::barch_to_bmp(IBarchImagePtr barch)
     return {};
   }
 
-  auto converter = barchclib0::converters::Barch2BMPConverter0::create();
-
-  assert(converter != nullptr);
+  assert(mdecoder != nullptr);
 
-  auto bmp = converter->convert(realb);
+  auto bmp = mdecoder->convert(realb);
 
   if (bmp == nullptr) {
     LOGE("Fail to convert into the bmp");
@@ -60,6 +68,59 @@ IBarchImagePtr LibMain::barch_to_bmp(IBarchImagePtr barch)
   return bmp;
 }
 
+bool LibMain::barch_to_buffer(IBarchImagePtr barch,
+                              const barchclib0::DecodeTarget& target)
+{
+  return barch_to_buffer(std::move(barch), target, {});
+}
+
+bool LibMain::barch_to_buffer(IBarchImagePtr barch,
+                              const barchclib0::DecodeTarget& target,
+                              const barchclib0::DecodeRegion& region)
+{
+  TRACE_SPAN("codec", "LibMain::barch_to_buffer");
+
+  BarchImagePtr realb = std::dynamic_pointer_cast<BarchImage>(barch);
+
+  if (realb == nullptr) {
+    LOGE("Not a barch image pointer provided");
+    return false;
+  }
+
+  assert(mdecoder != nullptr);
+
+  if (!mdecoder->convert(realb, target, region)) {
+    LOGE("Fail to decode into the buffer");
+    return false;
+  }
+
+  return true;
+}
+
+IBarchImagePtr LibMain::barch_to_thumbnail(IBarchImagePtr barch,
+                                           const size_t& scale)
+{
+  TRACE_SPAN("codec", "LibMain::barch_to_thumbnail");
+
+  BarchImagePtr realb = std::dynamic_pointer_cast<BarchImage>(barch);
+
+  if (realb == nullptr) {
+    LOGE("Not a barch image pointer provided");
+    return {};
+  }
+
+  assert(mdecoder != nullptr);
+
+  auto bmp = mdecoder->thumbnail(realb, scale);
+
+  if (bmp == nullptr) {
+    LOGE("Fail to decode the thumbnail");
+    return {};
+  }
+
+  return bmp;
+}
+
 IBarchImagePtr LibMain::read(const std::filesystem::path& imagePath)
 {
   if (imagePath.empty()) {
@@ -78,10 +139,12 @@ IBarchImagePtr LibMain::read(const std::filesystem::path& imagePath)
     return {};
   }
 
-  auto reader = create_reader(imagePath);
+  TRACE_SPAN_FILE("io", "LibMain::read", imagePath.string());
+
+  auto reader = reader_for(imagePath);
 
   if (reader == nullptr) {
-    LOGE("Fail to create appropriate file reader");
+    LOGE("Fail to find appropriate file reader");
     return {};
   }
 
@@ -95,17 +158,31 @@ IBarchImagePtr LibMain::read(const std::filesystem::path& imagePath)
   return barch;
 }
 
-LibMain::IReaderPtr LibMain::create_reader(
-    const std::filesystem::path& imagePath)
+IBarchImagePtr LibMain::read_thumbnail(const std::filesystem::path& imagePath)
+{
+  if (!barchclib0::readers::BarchReader0::is_barch(imagePath)) {
+    LOGE("Not a barch file path provided: " << imagePath);
+    return {};
+  }
+
+  TRACE_SPAN_FILE("io", "LibMain::read_thumbnail", imagePath.string());
+
+  assert(mbarchreader != nullptr);
+
+  return mbarchreader->read_thumbnail(imagePath);
+}
+
+LibMain::IReaderPtr LibMain::reader_for(
+    const std::filesystem::path& imagePath) const
 {
   if (barchclib0::readers::BMPReader::is_bmp(imagePath)) {
-    LOGD("Seems to require a bmp reader, creating");
-    return barchclib0::readers::BMPReader::create();
+    LOGD("Seems to require a bmp reader");
+    return mbmpreader;
   }
 
   if (barchclib0::readers::BarchReader0::is_barch(imagePath)) {
-    LOGD("Seems to require a barch reader, creating");
-    return barchclib0::readers::BarchReader0::create();
+    LOGD("Seems to require a barch reader");
+    return mbarchreader;
   }
 
   LOGE("Unrecognized file format provided: " << imagePath);
@@ -120,6 +197,19 @@ bool LibMain::write(IBarchImagePtr barch)
     return false;
   }
 
+  TRACE_SPAN_FILE("io", "LibMain::write", barch->filepath().string());
+
+  if (BMPImagePtr bmp = std::dynamic_pointer_cast<BMPImage>(barch)) {
+    assert(mbmpwriter != nullptr);
+
+    if (!mbmpwriter->write(bmp)) {
+      LOGE("Fail to write bmp image");
+      return false;
+    }
+
+    return true;
+  }
+
   BarchImagePtr realb = std::dynamic_pointer_cast<BarchImage>(barch);
 
   if (realb == nullptr) {
@@ -127,11 +217,9 @@ bool LibMain::write(IBarchImagePtr barch)
     return false;
   }
 
-  auto writer = barchclib0::writers::BarchWriter0::create();
+  assert(mbarchwriter != nullptr);
 
-  assert(writer != nullptr);
-
-  if (!writer->write(realb)) {
+  if (!mbarchwriter->write(realb)) {
     LOGE("Fail to write barch image");
     return false;
   }
@@ -139,13 +227,213 @@ bool LibMain::write(IBarchImagePtr barch)
   return true;
 }
 
-LibMain::ILibPtr LibMain::duplicate() { return create(); }
+barchclib0::BatchResults LibMain::convert_batch(
+    const barchclib0::BatchItems& items,
+    const barchclib0::BatchOptions& options)
+{
+  TRACE_SPAN("codec", "LibMain::convert_batch");
+
+  auto lib = duplicate();
+
+  if (options.preset.has_value()) {
+    lib->encoder_preset(*options.preset);
+  }
+
+  auto batch = barchclib0::batch::BatchConverter::create(std::move(lib));
+
+  assert(batch != nullptr);
+
+  return batch->convert(items, options);
+}
+
+std::pair<LibMain::ThreadPoolPtr, LibMainPtr> LibMain::executor()
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  if (mexecutor == nullptr) {
+    LOGD("Starting the library executor");
+    mexecutorlib = create();
+    mexecutorlib->buffer_pool(mpool);
+    apply_codec_settings(*mexecutorlib);
+    mexecutor = barchclib0::executor::ThreadPool::create(mexecutorthreads);
+  }
+
+  return {mexecutor, mexecutorlib};
+}
+
+void LibMain::executor_threads(const size_t& threads)
+{
+  ThreadPoolPtr previous;
+
+  {
+    std::lock_guard<std::mutex> guard{mexecutorm};
+
+    mexecutorthreads = threads;
+    previous = std::move(mexecutor);
+    mexecutor = nullptr;
+  }
+
+  // waits for the queued operations of the previous executor, if any
+  previous.reset();
+}
+
+std::future<IBarchImagePtr> LibMain::read_async(
+    const std::filesystem::path& imagePath)
+{
+  return submit([imagePath](LibMain& lib) { return lib.read(imagePath); });
+}
+
+void LibMain::read_async(const std::filesystem::path& imagePath,
+                         ImageCallback done)
+{
+  post([imagePath](LibMain& lib) { return lib.read(imagePath); },
+       std::move(done));
+}
+
+std::future<IBarchImagePtr> LibMain::bmp_to_barch_async(IBarchImagePtr bmp)
+{
+  return submit([bmp](LibMain& lib) { return lib.bmp_to_barch(bmp); });
+}
+
+void LibMain::bmp_to_barch_async(IBarchImagePtr bmp, ImageCallback done)
+{
+  post([bmp](LibMain& lib) { return lib.bmp_to_barch(bmp); }, std::move(done));
+}
+
+std::future<IBarchImagePtr> LibMain::barch_to_bmp_async(IBarchImagePtr barch)
+{
+  return submit([barch](LibMain& lib) { return lib.barch_to_bmp(barch); });
+}
+
+void LibMain::barch_to_bmp_async(IBarchImagePtr barch, ImageCallback done)
+{
+  post([barch](LibMain& lib) { return lib.barch_to_bmp(barch); },
+       std::move(done));
+}
+
+std::future<bool> LibMain::write_async(IBarchImagePtr image)
+{
+  return submit([image](LibMain& lib) { return lib.write(image); });
+}
+
+void LibMain::write_async(IBarchImagePtr image, WriteCallback done)
+{
+  post([image](LibMain& lib) { return lib.write(image); }, std::move(done));
+}
+
+void LibMain::barch_format(const barchclib0::BarchFormat& nformat)
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  mencoder->format(nformat);
+
+  if (mexecutorlib != nullptr) {
+    mexecutorlib->barch_format(nformat);
+  }
+}
+
+void LibMain::quantization(const barchclib0::Quantization& nquantization)
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  mencoder->quantization(nquantization);
+
+  if (mexecutorlib != nullptr) {
+    mexecutorlib->quantization(mencoder->quantization());
+  }
+}
+
+void LibMain::encoder_preset(const barchclib0::EncoderPreset& npreset)
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  mencoder->preset(npreset);
+
+  if (mexecutorlib != nullptr) {
+    mexecutorlib->encoder_preset(npreset);
+  }
+}
+
+void LibMain::decode_threads(const size_t& threads)
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  mdecoder->threads(threads);
+
+  if (mexecutorlib != nullptr) {
+    mexecutorlib->decode_threads(threads);
+  }
+}
+
+void LibMain::thumbnail_side(const size_t& side)
+{
+  std::lock_guard<std::mutex> guard{mexecutorm};
+
+  mencoder->thumbnail_side(side);
+
+  if (mexecutorlib != nullptr) {
+    mexecutorlib->thumbnail_side(side);
+  }
+}
+
+LibMain::ILibPtr LibMain::duplicate()
+{
+  auto lib = create();
+
+  lib->buffer_pool(mpool);
+  apply_codec_settings(*lib);
+
+  return lib;
+}
 
 IBarchImagePtr LibMain::create_empty_bmp()
 {
   LOGT("Creating empty BMP image instance");
 
-  return BMPImage::create();
+  auto bmp = BMPImage::create();
+
+  bmp->pool(mpool);
+
+  return bmp;
+}
+
+void LibMain::buffer_pool(const BufferPoolPtr& npool)
+{
+  mpool = npool;
+
+  apply_pool();
+}
+
+const LibMain::BufferPoolPtr& LibMain::buffer_pool() const { return mpool; }
+
+void LibMain::apply_pool()
+{
+  mencoder->pool(mpool);
+  mdecoder->pool(mpool);
+  mbmpreader->pool(mpool);
+  mbarchreader->pool(mpool);
+}
+
+void LibMain::failed_operation(const std::exception_ptr& error)
+{
+  try {
+    std::rethrow_exception(error);
+  }
+  catch (const std::exception& e) {
+    LOGE("Exception in the asynchronous operation: " << e.what());
+  }
+  catch (...) {
+    LOGE("Unknown exception in the asynchronous operation");
+  }
+}
+
+void LibMain::apply_codec_settings(LibMain& lib) const
+{
+  lib.mencoder->format(mencoder->format());
+  lib.mencoder->decision(mencoder->decision());
+  lib.mencoder->quantization(mencoder->quantization());
+  lib.mdecoder->threads(mdecoder->threads());
+  lib.mencoder->thumbnail_side(mencoder->thumbnail_side());
 }
 
 LibMainPtr LibMain::create() { return std::make_shared<LibMain>(); }
@@ -1,13 +1,27 @@
 #ifndef YOUR_CPP_APP_TEMPLATE_PROJECT_LIBRARYMAIN_CLASS_H
 #define YOUR_CPP_APP_TEMPLATE_PROJECT_LIBRARYMAIN_CLASS_H
 
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <utility>
 
 #include "IBarchImage.h"
 #include "ILib.h"
+#include "src/lib/libmain/converters/BMP2BarchConverter0.h"
+#include "src/lib/libmain/converters/Barch2BMPConverter0.h"
+#include "src/lib/libmain/executor/ThreadPool.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
+#include "src/lib/libmain/memory/BufferPool.h"
+#include "src/lib/libmain/readers/BMPReader.h"
+#include "src/lib/libmain/readers/BarchReader0.h"
 #include "src/lib/libmain/readers/IReader.h"
+#include "src/lib/libmain/writers/BMPWriter.h"
+#include "src/lib/libmain/writers/BarchWriter0.h"
 
 namespace lib0impl
 {
@@ -22,9 +36,11 @@ class LibMain : virtual public barchclib0::ILib
   using BarchImagePtr = barchclib0::BarchImagePtr;
   using BarchImage = barchclib0::BarchImage;
   using IReaderPtr = barchclib0::readers::IReaderPtr;
+  using ThreadPoolPtr = barchclib0::executor::ThreadPoolPtr;
+  using BufferPoolPtr = barchclib0::memory::BufferPoolPtr;
 
   virtual ~LibMain() = default;
-  LibMain() = default;
+  LibMain();
 
   /// @brief Converts the given BMP file IBarchImage instance into the barch
   virtual IBarchImagePtr bmp_to_barch(IBarchImagePtr bmp) override;
@@ -32,20 +48,157 @@ class LibMain : virtual public barchclib0::ILib
   /// @brief Converts the given barch file IBarchImage instance into the BMP
   virtual IBarchImagePtr barch_to_bmp(IBarchImagePtr barch) override;
 
+  virtual bool barch_to_buffer(
+      IBarchImagePtr barch, const barchclib0::DecodeTarget& target) override;
+
+  virtual bool barch_to_buffer(
+      IBarchImagePtr barch, const barchclib0::DecodeTarget& target,
+      const barchclib0::DecodeRegion& region) override;
+
+  virtual IBarchImagePtr barch_to_thumbnail(IBarchImagePtr barch,
+                                            const size_t& scale) override;
+
   /// @brief Tries to read image by given filepath. BMP and barch only!
   virtual IBarchImagePtr read(const std::filesystem::path& imagePath) override;
 
-  /// @brief Tries to write barch data into given file. Barch only!
+  /// @brief Tries to write image data into it's file path. BMP and barch only!
   virtual bool write(IBarchImagePtr barch) override;
 
+  virtual IBarchImagePtr read_thumbnail(
+      const std::filesystem::path& imagePath) override;
+
+  virtual barchclib0::BatchResults convert_batch(
+      const barchclib0::BatchItems& items,
+      const barchclib0::BatchOptions& options) override;
+
+  virtual std::future<IBarchImagePtr> read_async(
+      const std::filesystem::path& imagePath) override;
+  virtual void read_async(const std::filesystem::path& imagePath,
+                          ImageCallback done) override;
+
+  virtual std::future<IBarchImagePtr> bmp_to_barch_async(
+      IBarchImagePtr bmp) override;
+  virtual void bmp_to_barch_async(IBarchImagePtr bmp,
+                                  ImageCallback done) override;
+
+  virtual std::future<IBarchImagePtr> barch_to_bmp_async(
+      IBarchImagePtr barch) override;
+  virtual void barch_to_bmp_async(IBarchImagePtr barch,
+                                  ImageCallback done) override;
+
+  virtual std::future<bool> write_async(IBarchImagePtr image) override;
+  virtual void write_async(IBarchImagePtr image, WriteCallback done) override;
+
+  virtual void executor_threads(const size_t& threads) override;
+
+  virtual void barch_format(const barchclib0::BarchFormat& nformat) override;
+
+  virtual void quantization(
+      const barchclib0::Quantization& nquantization) override;
+
+  virtual void encoder_preset(
+      const barchclib0::EncoderPreset& npreset) override;
+
+  virtual void decode_threads(const size_t& threads) override;
+
+  virtual void thumbnail_side(const size_t& side) override;
+
+  /**
+   * @brief The duplicate shares the buffer pool and the codec settings, but
+   * not the executor of the original
+   */
   virtual ILibPtr duplicate() override;
 
   virtual IBarchImagePtr create_empty_bmp() override;
 
+  /**
+   * @brief Plugs in the pool the images and converters draw the buffers from.
+   * To be set before the conversions start.
+   */
+  virtual void buffer_pool(const BufferPoolPtr& npool);
+  virtual const BufferPoolPtr& buffer_pool() const;
+
   static LibMainPtr create();
 
  private:
-  static IReaderPtr create_reader(const std::filesystem::path& imagePath);
+  /// @brief Picks the cached reader for the file format
+  IReaderPtr reader_for(const std::filesystem::path& imagePath) const;
+
+  /// @brief Hands the pool over to the cached codec instances
+  void apply_pool();
+
+  /// @brief Copies the codec settings into the other library instance
+  void apply_codec_settings(LibMain& lib) const;
+
+  BufferPoolPtr mpool{barchclib0::memory::BufferPool::create()};
+
+  // The codec instances are created once per library instance instead of
+  // per call. All the calls and threads share them: they keep no per-call
+  // state, the encoder settings are the snapshot every conversion takes at
+  // its start and the setters replace whole.
+  const barchclib0::converters::BMP2BarchConverter0Ptr mencoder{
+      barchclib0::converters::BMP2BarchConverter0::create()};
+  const barchclib0::converters::Barch2BMPConverter0Ptr mdecoder{
+      barchclib0::converters::Barch2BMPConverter0::create()};
+  const barchclib0::readers::BMPReaderPtr mbmpreader{
+      barchclib0::readers::BMPReader::create()};
+  const barchclib0::readers::BarchReader0Ptr mbarchreader{
+      barchclib0::readers::BarchReader0::create()};
+  const barchclib0::writers::BMPWriterPtr mbmpwriter{
+      barchclib0::writers::BMPWriter::create()};
+  const barchclib0::writers::BarchWriter0Ptr mbarchwriter{
+      barchclib0::writers::BarchWriter0::create()};
+
+  /**
+   * @brief Starts the executor on demand. Returns it with the separate
+   * library instance for the tasks, so the queued operations never refer to
+   * this object. The settings changes reach it as the new snapshots.
+   */
+  std::pair<ThreadPoolPtr, LibMainPtr> executor();
+
+  /// @brief Logs the exception the posted operation threw
+  static void failed_operation(const std::exception_ptr& error);
+
+  template <typename F>
+  auto submit(F&& operation)
+  {
+    const auto exec = executor();
+
+    return exec.first->submit(
+        [lib = exec.second, operation = std::forward<F>(operation)]() {
+          return operation(*lib);
+        });
+  }
+
+  template <typename F, typename C>
+  void post(F&& operation, C&& done)
+  {
+    const auto exec = executor();
+
+    exec.first->post([lib = exec.second,
+                      operation = std::forward<F>(operation),
+                      done = std::forward<C>(done)]() {
+      // The callback is called anyway, with nullptr or false on the throw
+      decltype(operation(*lib)) result{};
+
+      try {
+        result = operation(*lib);
+      }
+      catch (...) {
+        failed_operation(std::current_exception());
+      }
+
+      if (done != nullptr) {
+        done(std::move(result));
+      }
+    });
+  }
+
+  std::mutex mexecutorm;
+  size_t mexecutorthreads{0U};
+  LibMainPtr mexecutorlib;
+  // The last member: destroyed first, finishing the queued operations
+  ThreadPoolPtr mexecutor;
 };
 
 using IBarchImagePtr = LibMain::IBarchImagePtr;
@@ -0,0 +1,298 @@
+#include "src/lib/libmain/batch/BatchConverter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/lib/libmain/images/BMPImage.h"
+#include "src/lib/libmain/images/BarchImage.h"
+#include "src/log/log.h"
+#include "src/log/trace.h"
+
+namespace barchclib0::batch
+{
+
+BatchConverter::BatchConverter(ILibPtr nlib) : mlib{std::move(nlib)} {}
+
+BatchConverterPtr BatchConverter::create(ILibPtr nlib)
+{
+  return std::make_shared<BatchConverter>(std::move(nlib));
+}
+
+size_t BatchConverter::workers_count(const BatchOptions& options)
+{
+  if (options.threads != 0U) {
+    return options.threads;
+  }
+
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+BatchResults BatchConverter::convert(const BatchItems& items,
+                                     const BatchOptions& options)
+{
+  if (mlib == nullptr) {
+    LOGE("No library instance provided");
+    return {};
+  }
+
+  if (items.empty()) {
+    return {};
+  }
+
+  mstop.store(false);
+
+  const size_t workers = workers_count(options);
+
+  LOGD("Batch of " << items.size() << " files with " << workers
+                   << " codec workers");
+
+  TaskQueue writeq{workers * queue_per_worker};
+
+  BatchResults results;
+
+  std::thread writer{[&]() {
+    TRACE_THREAD_NAME("Batch writer");
+    results = write_stage(items, options, writeq);
+  }};
+
+  // The writer is released and joined on the throwing stages too
+  struct WriterJoin
+  {
+    ~WriterJoin()
+    {
+      queue.close();
+
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+
+    TaskQueue& queue;
+    std::thread& thread;
+  } join{writeq, writer};
+
+  {
+    auto scheduler = executor::WorkStealingScheduler::create(workers);
+
+    read_stage(items, options, *scheduler, writeq, workers * queue_per_worker);
+  }
+
+  writeq.close();
+  writer.join();
+
+  return results;
+}
+
+void BatchConverter::fail(const BatchOptions& options)
+{
+  if (options.fail_fast) {
+    mstop.store(true);
+  }
+}
+
+void BatchConverter::read_stage(const BatchItems& items,
+                                const BatchOptions& options,
+                                executor::WorkStealingScheduler& scheduler,
+                                TaskQueue& dst, const size_t& inflightLimit)
+{
+  for (size_t index = 0U; index < items.size() && !mstop.load(); ++index) {
+    const BatchItem& item = items[index];
+    Task task;
+
+    task.index = index;
+
+    if (item.output.empty()) {
+      task.error = "No output path provided";
+    } else {
+      task.image = mlib->read(item.input);
+
+      if (task.image == nullptr) {
+        task.error = "Fail to read the file";
+      }
+    }
+
+    if (!task.error.empty()) {
+      LOGE(task.error << ": " << item.input);
+      fail(options);
+
+      if (!dst.push(std::move(task))) {
+        break;
+      }
+
+      continue;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock{minflightm};
+
+      minflightcv.wait(lock, [&]() { return minflight < inflightLimit; });
+      ++minflight;
+    }
+
+    auto shared = std::make_shared<Task>(std::move(task));
+
+    scheduler.spawn([this, &items, &options, &dst, shared]() {
+      // The stage waits for the in-flight count: it is released anyway
+      try {
+        codec_task(items, options, std::move(*shared), dst);
+      }
+      catch (const std::exception& e) {
+        LOGE("Exception in the codec task: " << e.what());
+      }
+      catch (...) {
+        LOGE("Unknown exception in the codec task");
+      }
+
+      std::lock_guard<std::mutex> guard{minflightm};
+
+      --minflight;
+      minflightcv.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock{minflightm};
+
+  minflightcv.wait(lock, [this]() { return minflight == 0U; });
+}
+
+void BatchConverter::codec_task(const BatchItems& items,
+                                const BatchOptions& options, Task&& task,
+                                TaskQueue& dst)
+{
+  if (mstop.load()) {
+    // fail-fast: the unprocessed items are reported as skipped
+    return;
+  }
+
+  try {
+    task.image = convert_image(task.image);
+
+    if (task.image == nullptr) {
+      task.error = "Fail to convert the image";
+    }
+  }
+  catch (const std::exception& e) {
+    task.image = nullptr;
+    task.error = e.what();
+  }
+  catch (...) {
+    task.image = nullptr;
+    task.error = "Unknown exception during the conversion";
+  }
+
+  if (task.image == nullptr) {
+    LOGE(task.error << ": " << items[task.index].input);
+    fail(options);
+  } else {
+    task.image->filepath(items[task.index].output);
+  }
+
+  dst.push(std::move(task));
+}
+
+IBarchImagePtr BatchConverter::convert_image(IBarchImagePtr image)
+{
+  assert(image != nullptr);
+
+  if (std::dynamic_pointer_cast<BMPImage>(image) != nullptr) {
+    return mlib->bmp_to_barch(image);
+  }
+
+  return mlib->barch_to_bmp(image);
+}
+
+BatchResults BatchConverter::write_stage(const BatchItems& items,
+                                         const BatchOptions& options,
+                                         TaskQueue& src)
+{
+  BatchResults results;
+  std::map<size_t, BatchResult> pending;
+  std::vector<bool> done(items.size(), false);
+  size_t next = 0U;
+
+  results.reserve(items.size());
+
+  const auto deliver = [&](BatchResult&& result) {
+    // The callback runs on the writer thread: never let it escape there
+    try {
+      if (options.on_result != nullptr) {
+        options.on_result(result);
+      }
+    }
+    catch (const std::exception& e) {
+      LOGE("Exception in the result callback: " << e.what());
+    }
+    catch (...) {
+      LOGE("Unknown exception in the result callback");
+    }
+
+    results.emplace_back(std::move(result));
+  };
+
+  const auto collect = [&](BatchResult&& result) {
+    done[result.index] = true;
+
+    if (options.order == BatchOrder::completion) {
+      deliver(std::move(result));
+      return;
+    }
+
+    pending.emplace(result.index, std::move(result));
+
+    while (!pending.empty() && pending.begin()->first == next) {
+      deliver(std::move(pending.begin()->second));
+      pending.erase(pending.begin());
+      ++next;
+    }
+  };
+
+  while (auto task = src.pop()) {
+    BatchResult result;
+
+    result.index = task->index;
+    result.input = items[task->index].input;
+    result.output = items[task->index].output;
+    result.error = std::move(task->error);
+
+    if (result.error.empty() && !mlib->write(task->image)) {
+      result.error = "Fail to write the file";
+      LOGE(result.error << ": " << result.output);
+      fail(options);
+    }
+
+    result.status =
+        result.error.empty() ? BatchStatus::success : BatchStatus::failed;
+
+    if (auto barch = std::dynamic_pointer_cast<BarchImage>(task->image)) {
+      result.quantization_error = barch->quantization_error();
+    }
+
+    collect(std::move(result));
+  }
+
+  for (size_t index = 0U; index < items.size(); ++index) {
+    if (done[index]) {
+      continue;
+    }
+
+    BatchResult result;
+
+    result.index = index;
+    result.input = items[index].input;
+    result.output = items[index].output;
+    result.status = BatchStatus::skipped;
+
+    collect(std::move(result));
+  }
+
+  return results;
+}
+
+}  // namespace barchclib0::batch
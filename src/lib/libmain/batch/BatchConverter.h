@@ -0,0 +1,96 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCHCONVERTER_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCHCONVERTER_CLASS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Batch.h"
+#include "IBarchImage.h"
+#include "ILib.h"
+#include "src/lib/libmain/batch/BlockingQueue.h"
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
+
+namespace barchclib0::batch
+{
+
+/**
+ * @brief The pipelined batch converter. A single reader thread loads the
+ * input files, the work-stealing scheduler converts them and a single writer
+ * thread stores the results, so the disk I/O overlaps with the encoding.
+ * Every file is a scheduler task, the large images are split further into
+ * the row-range tasks by the converters. The in-flight files count is
+ * bounded.
+ */
+class BatchConverter : public std::enable_shared_from_this<BatchConverter>
+{
+ public:
+  using BatchConverterPtr = std::shared_ptr<BatchConverter>;
+
+  virtual ~BatchConverter() = default;
+
+  /**
+   * @param nlib The library instance to perform the single file operations.
+   * Called from the several threads at once, so must be stateless.
+   */
+  explicit BatchConverter(ILibPtr nlib);
+
+  /**
+   * @brief Converts all the given items. Blocks until the whole batch is
+   * processed.
+   *
+   * @return Returns the result for each given item in the options order.
+   */
+  virtual BatchResults convert(const BatchItems& items,
+                               const BatchOptions& options);
+
+  /// @brief The codec workers count for the given options.
+  static size_t workers_count(const BatchOptions& options);
+
+  static BatchConverterPtr create(ILibPtr nlib);
+
+ private:
+  /**
+   * @brief The item travelling through the pipeline stages. The failed
+   * items keep travelling with the error to get their result in order.
+   */
+  struct Task
+  {
+    size_t index{0U};
+    IBarchImagePtr image;
+    std::string error;
+  };
+
+  using TaskQueue = BlockingQueue<Task>;
+
+  inline static constexpr const size_t queue_per_worker = 2U;
+
+  void read_stage(const BatchItems& items, const BatchOptions& options,
+                  executor::WorkStealingScheduler& scheduler, TaskQueue& dst,
+                  const size_t& inflightLimit);
+  void codec_task(const BatchItems& items, const BatchOptions& options,
+                  Task&& task, TaskQueue& dst);
+  BatchResults write_stage(const BatchItems& items,
+                           const BatchOptions& options, TaskQueue& src);
+
+  IBarchImagePtr convert_image(IBarchImagePtr image);
+
+  void fail(const BatchOptions& options);
+
+  ILibPtr mlib;
+  std::atomic_bool mstop{false};
+
+  std::mutex minflightm;
+  std::condition_variable minflightcv;
+  size_t minflight{0U};
+};
+
+using BatchConverterPtr = BatchConverter::BatchConverterPtr;
+
+}  // namespace barchclib0::batch
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BATCHCONVERTER_CLASS_H
@@ -0,0 +1,93 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BLOCKINGQUEUE_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BLOCKINGQUEUE_CLASS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace barchclib0::batch
+{
+
+/**
+ * @brief The bounded multi-producer multi-consumer queue connecting the
+ * batch pipeline stages. The capacity bound keeps the count of decoded
+ * images in memory limited when a later stage is slower.
+ */
+template <typename T>
+class BlockingQueue
+{
+ public:
+  explicit BlockingQueue(const size_t& capacity)
+      : mcapacity{capacity == 0U ? 1U : capacity}
+  {
+  }
+
+  /**
+   * @brief Waits for the free space and stores the value.
+   *
+   * @return Returns false if the queue is closed.
+   */
+  bool push(T&& value)
+  {
+    std::unique_lock<std::mutex> lock{mm};
+
+    mnotfull.wait(lock,
+                  [this] { return mclosed || mqueue.size() < mcapacity; });
+
+    if (mclosed) {
+      return false;
+    }
+
+    mqueue.emplace_back(std::move(value));
+    mnotempty.notify_one();
+
+    return true;
+  }
+
+  /**
+   * @brief Waits for the value.
+   *
+   * @return Returns the empty optional if the queue is closed and drained.
+   */
+  std::optional<T> pop()
+  {
+    std::unique_lock<std::mutex> lock{mm};
+
+    mnotempty.wait(lock, [this] { return mclosed || !mqueue.empty(); });
+
+    if (mqueue.empty()) {
+      return std::nullopt;
+    }
+
+    T value = std::move(mqueue.front());
+    mqueue.pop_front();
+    mnotfull.notify_one();
+
+    return value;
+  }
+
+  /// @brief No more pushes accepted, consumers drain the rest and stop.
+  void close()
+  {
+    std::lock_guard<std::mutex> lock{mm};
+
+    mclosed = true;
+    mnotempty.notify_all();
+    mnotfull.notify_all();
+  }
+
+ private:
+  const size_t mcapacity;
+  bool mclosed{false};
+  std::deque<T> mqueue;
+  std::mutex mm;
+  std::condition_variable mnotempty;
+  std::condition_variable mnotfull;
+};
+
+}  // namespace barchclib0::batch
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BLOCKINGQUEUE_CLASS_H
@@ -0,0 +1,332 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BatchConverter_includes.h"
+#include "src/lib/libmain/LibMain.h"
+#include "src/lib/libmain/batch/BatchConverter.h"
+
+using namespace barchclib0;
+using namespace barchclib0::batch;
+using namespace lib0impl;
+using namespace testing;
+
+class CTEST_BatchConverter : public Test
+{
+ public:
+  inline static const std::filesystem::path images_root =
+      ct_batch::REAL_IMAGES_ROOT;
+
+  inline static const std::filesystem::path i1 =
+      images_root / "test-image-1-gs.bmp";
+  inline static const std::filesystem::path i2 =
+      images_root / "test-image-2-gs.bmp";
+
+  inline static const std::filesystem::path testdir =
+      std::filesystem::path{ct_batch::TEST_DATA_ROOT} / "CTEST_BatchConverter";
+
+  CTEST_BatchConverter() : lib{LibMain::create()}
+  {
+    if (!std::filesystem::is_directory(testdir)) {
+      EXPECT_TRUE(std::filesystem::create_directories(testdir));
+    }
+
+    EXPECT_NE(lib, nullptr);
+  }
+
+  static std::filesystem::path out(const std::string& name)
+  {
+    return testdir / name;
+  }
+
+  BatchItems encode_items(const size_t& count)
+  {
+    BatchItems items;
+
+    for (size_t iter = 0U; iter < count; ++iter) {
+      items.push_back({iter % 2U == 0U ? i1 : i2,
+                       out("encode-" + std::to_string(iter) + ".barch")});
+    }
+
+    return items;
+  }
+
+  LibMainPtr lib;
+};
+
+/// @brief The library the encoding of which always throws
+class ThrowingLibMain : public LibMain
+{
+ public:
+  virtual IBarchImagePtr bmp_to_barch(IBarchImagePtr) override
+  {
+    throw std::bad_alloc();
+  }
+};
+
+TEST_F(CTEST_BatchConverter, workers_count_bounds)
+{
+  BatchOptions options;
+
+  options.threads = 8U;
+  EXPECT_EQ(BatchConverter::workers_count(options), 8U);
+
+  // Not bound by the batch size: a single file is split into the row tasks
+  options.threads = 0U;
+  EXPECT_GE(BatchConverter::workers_count(options), 1U);
+}
+
+TEST_F(CTEST_BatchConverter, empty_batch_empty_results)
+{
+  EXPECT_TRUE(lib->convert_batch({}, {}).empty());
+}
+
+TEST_F(CTEST_BatchConverter, encode_batch_input_order_success)
+{
+  const BatchItems items = encode_items(4U);
+  BatchOptions options;
+
+  options.threads = 3U;
+
+  const BatchResults results = lib->convert_batch(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+
+  for (size_t iter = 0U; iter < results.size(); ++iter) {
+    EXPECT_EQ(results[iter].index, iter);
+    EXPECT_EQ(results[iter].input, items[iter].input);
+    EXPECT_EQ(results[iter].output, items[iter].output);
+    EXPECT_EQ(results[iter].status, BatchStatus::success);
+    EXPECT_TRUE(results[iter].error.empty());
+    EXPECT_TRUE(std::filesystem::is_regular_file(items[iter].output));
+  }
+}
+
+TEST_F(CTEST_BatchConverter, encode_decode_round_trip_success)
+{
+  const BatchItems encode = {{i1, out("trip-1.barch")},
+                             {i2, out("trip-2.barch")}};
+  const BatchItems decode = {{out("trip-1.barch"), out("trip-1.bmp")},
+                             {out("trip-2.barch"), out("trip-2.bmp")}};
+  BatchOptions options;
+
+  options.threads = 2U;
+
+  for (const auto& result : lib->convert_batch(encode, options)) {
+    EXPECT_EQ(result.status, BatchStatus::success);
+  }
+
+  for (const auto& result : lib->convert_batch(decode, options)) {
+    EXPECT_EQ(result.status, BatchStatus::success);
+  }
+
+  for (size_t iter = 0U; iter < encode.size(); ++iter) {
+    auto source = lib->read(encode[iter].input);
+    auto decoded = lib->read(decode[iter].output);
+
+    ASSERT_NE(source, nullptr);
+    ASSERT_NE(decoded, nullptr);
+
+    EXPECT_EQ(decoded->width(), source->width());
+    EXPECT_EQ(decoded->height(), source->height());
+    EXPECT_EQ(decoded->data(), source->data());
+  }
+}
+
+TEST_F(CTEST_BatchConverter, failed_item_does_not_stop_batch)
+{
+  const BatchItems items = {{i1, out("partial-1.barch")},
+                            {out("no-such-file.bmp"), out("partial-2.barch")},
+                            {i2, out("partial-3.barch")}};
+  BatchOptions options;
+
+  options.threads = 2U;
+
+  const BatchResults results = lib->convert_batch(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+
+  EXPECT_EQ(results[0].status, BatchStatus::success);
+  EXPECT_EQ(results[1].status, BatchStatus::failed);
+  EXPECT_FALSE(results[1].error.empty());
+  EXPECT_EQ(results[2].status, BatchStatus::success);
+}
+
+TEST_F(CTEST_BatchConverter, fail_fast_skips_the_rest)
+{
+  BatchItems items = encode_items(4U);
+
+  items.insert(items.begin(), {out("no-such-file.bmp"), out("ff.barch")});
+
+  BatchOptions options;
+
+  options.threads = 1U;
+  options.fail_fast = true;
+
+  const BatchResults results = lib->convert_batch(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+
+  EXPECT_EQ(results[0].status, BatchStatus::failed);
+
+  for (size_t iter = 1U; iter < results.size(); ++iter) {
+    EXPECT_EQ(results[iter].index, iter);
+    EXPECT_EQ(results[iter].status, BatchStatus::skipped);
+  }
+}
+
+TEST_F(CTEST_BatchConverter, empty_output_path_failure)
+{
+  const BatchResults results = lib->convert_batch({{i1, {}}}, {});
+
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_EQ(results[0].status, BatchStatus::failed);
+}
+
+TEST_F(CTEST_BatchConverter, completion_order_reports_every_item)
+{
+  const BatchItems items = encode_items(3U);
+  std::set<size_t> reported;
+  std::mutex reportedm;
+  BatchOptions options;
+
+  options.threads = 4U;
+  options.order = BatchOrder::completion;
+  options.on_result = [&](const BatchResult& result) {
+    std::lock_guard<std::mutex> guard{reportedm};
+    EXPECT_TRUE(reported.insert(result.index).second);
+  };
+
+  const BatchResults results = lib->convert_batch(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+  EXPECT_EQ(reported.size(), items.size());
+
+  for (const auto& result : results) {
+    EXPECT_EQ(result.status, BatchStatus::success);
+    EXPECT_EQ(result.input, items[result.index].input);
+  }
+}
+
+TEST_F(CTEST_BatchConverter, quantization_error_reported_success)
+{
+  const BatchItems encode = {{i1, out("quant-1.barch")}};
+  const BatchItems decode = {{out("quant-1.barch"), out("quant-1.bmp")}};
+
+  lib->quantization(Quantization{240U, 15U});
+
+  const BatchResults encoded = lib->convert_batch(encode, {});
+
+  ASSERT_EQ(encoded.size(), 1U);
+  EXPECT_EQ(encoded[0].status, BatchStatus::success);
+  EXPECT_LE(encoded[0].quantization_error, 15U);
+
+  const BatchResults decoded = lib->convert_batch(decode, {});
+
+  ASSERT_EQ(decoded.size(), 1U);
+  EXPECT_EQ(decoded[0].status, BatchStatus::success);
+  EXPECT_EQ(decoded[0].quantization_error, 0U);
+
+  auto source = lib->read(encode[0].input);
+  auto restored = lib->read(decode[0].output);
+
+  ASSERT_NE(source, nullptr);
+  ASSERT_NE(restored, nullptr);
+  ASSERT_EQ(restored->data().size(), source->data().size());
+
+  unsigned int error = 0U;
+
+  for (size_t iter = 0U; iter < source->data().size(); ++iter) {
+    const int diff = source->data()[iter] - restored->data()[iter];
+
+    error = std::max(error, static_cast<unsigned int>(std::abs(diff)));
+  }
+
+  EXPECT_EQ(error, encoded[0].quantization_error);
+}
+
+TEST_F(CTEST_BatchConverter, presets_trade_size_success)
+{
+  BatchOptions options;
+  std::vector<std::uintmax_t> sizes;
+
+  for (const auto preset : {EncoderPreset::fast, EncoderPreset::balanced,
+                            EncoderPreset::max_ratio}) {
+    const auto output =
+        out("preset-" + std::to_string(sizes.size()) + ".barch");
+
+    options.preset = preset;
+
+    const BatchResults results = lib->convert_batch({{i1, output}}, options);
+
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0].status, BatchStatus::success);
+
+    sizes.push_back(std::filesystem::file_size(output));
+
+    auto barch = lib->read(output);
+    auto restored = lib->barch_to_bmp(barch);
+    auto source = lib->read(i1);
+
+    ASSERT_NE(restored, nullptr);
+    ASSERT_NE(source, nullptr);
+    EXPECT_EQ(restored->data(), source->data());
+  }
+
+  EXPECT_LE(sizes[1], sizes[0]);
+  EXPECT_LT(sizes[2], sizes[1]);
+
+  // The batch preset leaves the library settings untouched
+  auto bmp = lib->read(i1);
+  auto barch = std::dynamic_pointer_cast<BarchImage>(lib->bmp_to_barch(bmp));
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_EQ(barch->format(), BarchFormat::ba000);
+}
+
+TEST_F(CTEST_BatchConverter, throwing_conversion_reported_failed)
+{
+  auto converter = BatchConverter::create(std::make_shared<ThrowingLibMain>());
+  const BatchItems items = {{i1, out("throwing-1.barch")},
+                            {i2, out("throwing-2.barch")}};
+  BatchOptions options;
+
+  options.threads = 2U;
+
+  const BatchResults results = converter->convert(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+
+  for (const auto& result : results) {
+    EXPECT_EQ(result.status, BatchStatus::failed);
+    EXPECT_FALSE(result.error.empty());
+  }
+}
+
+TEST_F(CTEST_BatchConverter, throwing_result_callback_reports_every_item)
+{
+  const BatchItems items = encode_items(3U);
+  BatchOptions options;
+
+  options.threads = 2U;
+  options.on_result = [](const BatchResult&) {
+    throw std::runtime_error("The callback failed");
+  };
+
+  const BatchResults results = lib->convert_batch(items, options);
+
+  ASSERT_EQ(results.size(), items.size());
+
+  for (const auto& result : results) {
+    EXPECT_EQ(result.status, BatchStatus::success);
+  }
+}
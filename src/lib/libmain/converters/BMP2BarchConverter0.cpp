@@ -1,16 +1,19 @@
 #include "src/lib/libmain/converters/BMP2BarchConverter0.h"
 
-#include <bitset>
+#include <algorithm>
 #include <cassert>
-#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <exception>
-#include <filesystem>
-#include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "IBarchImage.h"
 #include "src/log/log.h"
+#include "src/log/trace.h"
 
 namespace barchclib0::converters
 {
@@ -47,316 +50,696 @@ BarchImagePtr BMP2BarchConverter0::convert(BMPImagePtr bmp)
 
   assert(barch != nullptr);
 
-  barch->width(bmp->width());
+  const SettingsPtr current = snapshot();
+  const Settings& settings = *current;
 
-  LOGT("Initiating bool vector for " << bmp->height() << " images rows");
+  const size_t width = bmp->width();
+  const size_t height = bmp->height();
+  const barchdata& original = bmp->data();
 
-  barch->lines_table(analyze_lines(bmp));
+  if (original.size() < width * height) {
+    LOGE("Image data (" << original.size() << ") is less than its size "
+                        << width << "x" << height);
+    return {};
+  }
 
-  const auto& lines = barch->lines_table();
+  const bool lossy = !settings.quantization.lossless();
+  barchdata quantized;
 
-  assert(!lines.empty());
-  assert(lines.size() == bmp->height());
+  if (lossy) {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::quantize");
 
-  /* need to perform the compression */
-  for (size_t liter = zero; liter < bmp->height(); ++liter) {
-    auto line = bmp->line(liter);
+    quantized = memory::BufferPool::acquire_from(mpool, width * height);
+    quantized.resize(width * height);
 
-    if (liter < lines.size() && lines[liter]) {
-      LOGT("Compressing line " << liter);
-      line = huffman_compress(line);
-    }
+    std::mutex errorm;
+    unsigned int error = 0U;
+
+    for_rows(height, width, [&](size_t begin, size_t end) {
+      const unsigned int rowserror =
+          quantize_rows(original.data(), width, begin, end,
+                        settings.quantization, quantized.data());
+
+      std::lock_guard<std::mutex> guard{errorm};
+
+      error = std::max(error, rowserror);
+    });
+
+    barch->quantization_error(error);
+  }
+
+  const barchdata& pixels = lossy ? quantized : original;
+
+  barch->pool(mpool);
+  barch->width(width);
+  barch->format(settings.format);
+
+  // Not the std::vector<bool>: the row tasks write the neighbour flags
+  std::vector<unsigned char> compressed(height, row_raw);
+  barchscans lines(height);
+
+  // The images the rows sample predicts incompressible get the raw rows
+  bool incompressible = false;
+
+  if (settings.min_saving > 0.0 && height >= sampled_rows * 2U) {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::sampled_saving");
+
+    const double saving =
+        sampled_saving(pixels.data(), width, height, settings);
+
+    incompressible = saving < settings.min_saving;
+
+    LOGD("Sampled rows saving " << saving << " of " << width << "x"
+                                << height << (incompressible ? ", raw" : ""));
+  }
+
+  if (row_refs(settings.format) && !incompressible) {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::find_repeated_rows");
+
+    find_repeated_rows(pixels.data(), width, height, compressed);
+  }
+
+  PixelHuffman0 huffman;
+
+  if (entropy_coded(settings.format)) {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::build_entropy_table");
+
+    huffman = PixelHuffman0::build(
+        incompressible
+            ? PixelHuffman0::counts{}
+            : count_as_is_pixels(pixels.data(), width, height, compressed,
+                                 settings));
+
+    barch->entropy_lengths(
+        barchdata(huffman.lengths().cbegin(), huffman.lengths().cend()));
+  }
+
+  const PixelHuffman0* const table =
+      entropy_coded(settings.format) ? &huffman : nullptr;
+
+  {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::compress_lines");
+
+    for_rows(height, width, [&](size_t begin, size_t end) {
+      if (incompressible) {
+        for (size_t liter = begin; liter < end; ++liter) {
+          const unsigned char* const rowb = pixels.data() + liter * width;
+
+          lines[liter] = memory::BufferPool::acquire_from(mpool, width);
+          lines[liter].assign(rowb, rowb + width);
+        }
+      } else if (long_runs(settings.format)) {
+        compress_rows<codec_kernel_runs>(pixels.data(), width, begin, end,
+                                         compressed, lines, table, settings);
+      } else {
+        compress_rows<codec_kernel>(pixels.data(), width, begin, end,
+                                    compressed, lines, nullptr, settings);
+      }
+    });
+  }
+
+  barch->lines_table(linestable(compressed.cbegin(), compressed.cend()));
+
+  if (row_fills(settings.format)) {
+    fillstable fills(height, RowFill::none);
+
+    std::transform(compressed.cbegin(), compressed.cend(), fills.begin(),
+                   [](const unsigned char& code) {
+                     return code == row_whites   ? RowFill::whites
+                            : code == row_blacks ? RowFill::blacks
+                                                 : RowFill::none;
+                   });
+
+    barch->fills_table(std::move(fills));
+  }
+
+  if (row_predicts(settings.format)) {
+    predictedtable predicted(height, false);
+
+    std::transform(compressed.cbegin(), compressed.cend(), predicted.begin(),
+                   [](const unsigned char& code) {
+                     return code == row_predicted;
+                   });
+
+    barch->predicted_table(std::move(predicted));
+  }
+
+  if (row_refs(settings.format)) {
+    refstable refs(height, 0U);
+
+    std::transform(compressed.cbegin(), compressed.cend(), refs.begin(),
+                   [](const unsigned char& code) -> size_t {
+                     return (code & row_reference) != 0U
+                                ? (code & row_ref_mask) + 1U
+                                : 0U;
+                   });
+
+    barch->refs_table(std::move(refs));
+  }
 
-    barch->append_line(line);
+  for (auto& line : lines) {
+    barch->append_line(std::move(line));
   }
 
+  if (settings.thumbnail_side > 0U) {
+    TRACE_SPAN("codec", "BMP2BarchConverter0::thumbnail");
+
+    const size_t side = settings.thumbnail_side;
+    const size_t scale = (std::max(width, height) + side - 1U) / side;
+    const size_t twidth = (width + scale - 1U) / scale;
+    const size_t theight = (height + scale - 1U) / scale;
+
+    barchdata preview(twidth * theight);
+
+    for_rows(theight, width * scale, [&](size_t begin, size_t end) {
+      thumbnail_rows(pixels.data(), width, height, scale, begin, end,
+                     preview.data());
+    });
+
+    barch->thumbnail(std::move(preview), twidth, theight);
+  }
+
+  memory::BufferPool::release_to(mpool, std::move(quantized));
+
   return barch;
 }
 
-std::vector<bool> BMP2BarchConverter0::analyze_lines(BMPImagePtr image)
+template <typename Kernel>
+void BMP2BarchConverter0::compress_rows(const unsigned char* pixels,
+                                        const size_t& width,
+                                        const size_t& begin, const size_t& end,
+                                        std::vector<unsigned char>& compressed,
+                                        barchscans& lines,
+                                        const PixelHuffman0* table,
+                                        const Settings& settings) const
 {
-  assert(image != nullptr);
+  const bool exact = settings.decision == CompressDecision::exact_size;
+  // The table coding needs the group codes even without the exact sizes
+  const bool classify = exact || table != nullptr;
+  const bool fills = row_fills(settings.format);
+  const bool predicts = row_predicts(settings.format);
+  const size_t groups = Kernel::groups_count(width);
+
+  // The group codes are computed once per row: for the exact size and for
+  // the encoding
+  barchdata codes;
+  barchdata residual;
+  barchdata rescodes;
+
+  if (classify) {
+    codes = memory::BufferPool::acquire_from(mpool, groups);
+    codes.resize(groups);
+  }
 
-  std::vector<bool> lines(image->height(), false);
+  const auto row_size = [&](const unsigned char* row,
+                            const unsigned char* rowcodes) {
+    return table != nullptr
+               ? Kernel::encoded_size(row, rowcodes, width, *table)
+               : Kernel::encoded_size(rowcodes, width);
+  };
 
-  for (size_t crow = zero; crow < image->height(); ++crow) {
-    const bool crowOpt = optimal_to_compress(image, crow);
-    LOGT("The image row " << (crow + 1) << " is optimal to compress: "
-                          << static_cast<unsigned int>(crowOpt));
-    lines[crow] = crowOpt;
+  if (predicts) {
+    residual = memory::BufferPool::acquire_from(mpool, width);
+    residual.resize(width);
   }
 
-  return lines;
-}
+  if (predicts && exact) {
+    rescodes = memory::BufferPool::acquire_from(mpool, groups);
+    rescodes.resize(groups);
+  }
 
-bool BMP2BarchConverter0::optimal_to_compress(BMPImagePtr image,
-                                              const size_t& rowIndex)
-{
-  assert(image != nullptr);
-
-  unsigned int c4thsWCount = zero;
-  unsigned int c4thsW = zero;
-  unsigned int c4thsBCount = zero;
-  unsigned int c4thsB = zero;
-
-  for (size_t coli = zero; coli < image->width(); ++coli) {
-    auto pix = image->pixel(coli, rowIndex);
-
-    if (is_white(pix)) {
-      c4thsW++;
-      c4thsB = zero;
-    } else if (is_black(pix)) {
-      c4thsB++;
-      c4thsW = zero;
+  for (size_t liter = begin; liter < end; ++liter) {
+    const unsigned char* const rowb = pixels + liter * width;
+    size_t encoded = 0U;
+
+    // The repeated rows are already marked
+    if (compressed[liter] != row_raw) {
+      continue;
     }
 
-    if (c4thsW >= get_batch_pixels_compress()) {
-      c4thsW = zero;
-      c4thsWCount++;
+    // The uniform rows are told by the table alone, the scanline stays empty
+    if (fills) {
+      compressed[liter] = uniform_row(rowb, width);
+
+      if (compressed[liter] != row_raw) {
+        continue;
+      }
     }
 
-    if (c4thsB >= get_batch_pixels_compress()) {
-      c4thsB = zero;
-      c4thsBCount++;
+    const unsigned char* src = rowb;
+    const unsigned char* srccodes = codes.data();
+
+    if (exact) {
+      Kernel::classify_row(rowb, width, codes.data());
+      encoded = row_size(rowb, codes.data());
+    } else if (Kernel::optimal_to_compress(rowb, width)) {
+      encoded = width + width / ucharbits + one;
+    }
+
+    // The residual against the row above is taken when it codes smaller
+    if (predicts && liter > 0U && (exact || encoded == 0U)) {
+      xnor_rows(rowb, rowb - width, width, residual.data());
+
+      if (exact) {
+        Kernel::classify_row(residual.data(), width, rescodes.data());
+
+        const size_t predicted = row_size(residual.data(), rescodes.data());
+
+        if (predicted < std::min(encoded, width)) {
+          encoded = predicted;
+          src = residual.data();
+          srccodes = rescodes.data();
+        }
+      } else if (Kernel::optimal_to_compress(residual.data(), width)) {
+        encoded = width + width / ucharbits + one;
+        src = residual.data();
+      }
+    }
+
+    if (encoded > 0U && (!exact || encoded < width)) {
+      LOGT("Compressing line " << liter);
+      compressed[liter] = src == rowb ? row_compressed : row_predicted;
+      lines[liter] = memory::BufferPool::acquire_from(mpool, encoded);
+
+      if (exact) {
+        Kernel::encode_row(src, width, srccodes, lines[liter], table);
+      } else if (table != nullptr) {
+        Kernel::classify_row(src, width, codes.data());
+        Kernel::encode_row(src, width, codes.data(), lines[liter], table);
+      } else {
+        Kernel::encode_row(src, width, lines[liter]);
+      }
+    } else {
+      lines[liter] = memory::BufferPool::acquire_from(mpool, width);
+      lines[liter].assign(rowb, rowb + width);
     }
   }
 
-  return (c4thsWCount + c4thsBCount) >= get_min_opt_2_compress();
+  memory::BufferPool::release_to(mpool, std::move(codes));
+  memory::BufferPool::release_to(mpool, std::move(residual));
+  memory::BufferPool::release_to(mpool, std::move(rescodes));
 }
 
-bool BMP2BarchConverter0::is_white(const PixelPtr& pix)
+double BMP2BarchConverter0::sampled_saving(const unsigned char* pixels,
+                                           const size_t& width,
+                                           const size_t& height,
+                                           const Settings& settings) const
 {
-  return (pix->y == two_five_five) ||
-         (pix->b == two_five_five && pix->g == two_five_five &&
-          pix->r == two_five_five);
-}
+  barchdata codes = memory::BufferPool::acquire_from(
+      mpool, codec_kernel::groups_count(width));
+  barchdata residual = memory::BufferPool::acquire_from(mpool, width);
 
-bool BMP2BarchConverter0::is_black(const PixelPtr& pix)
-{
-  return (pix->y == zero) ||
-         (pix->b == zero && pix->g == zero && pix->r == zero);
-}
+  codes.resize(codec_kernel::groups_count(width));
+  residual.resize(width);
 
-bool BMP2BarchConverter0::is_white(const unsigned char& val)
-{
-  return val == two_five_five;
-}
+  const auto sampled_row = [height, width, pixels](const size_t& sample) {
+    return pixels +
+           (sample * 2U + 1U) * height / (sampled_rows * 2U) * width;
+  };
 
-bool BMP2BarchConverter0::is_black(const unsigned char& val)
-{
-  return val == zero;
+  // The entropy coding saves on the photos too: the table of the sampled
+  // pixels stands for the one of the whole image
+  PixelHuffman0 huffman;
+
+  if (entropy_coded(settings.format)) {
+    PixelHuffman0::counts counts{};
+
+    for (size_t sample = 0U; sample < sampled_rows; ++sample) {
+      const unsigned char* const rowb = sampled_row(sample);
+
+      std::for_each(rowb, rowb + width,
+                    [&counts](const unsigned char& pix) { ++counts[pix]; });
+    }
+
+    huffman = PixelHuffman0::build(counts);
+  }
+
+  const PixelHuffman0* const table =
+      entropy_coded(settings.format) ? &huffman : nullptr;
+
+  size_t coded = 0U;
+
+  for (size_t sample = 0U; sample < sampled_rows; ++sample) {
+    const unsigned char* const rowb = sampled_row(sample);
+    const unsigned char* const above = rowb != pixels ? rowb - width : nullptr;
+
+    coded += long_runs(settings.format)
+                 ? sampled_row_size<codec_kernel_runs>(
+                       rowb, above, width, table, codes, residual, settings)
+                 : sampled_row_size<codec_kernel>(rowb, above, width, table,
+                                                  codes, residual, settings);
+  }
+
+  memory::BufferPool::release_to(mpool, std::move(codes));
+  memory::BufferPool::release_to(mpool, std::move(residual));
+
+  const auto raw = static_cast<double>(sampled_rows * width);
+
+  return (raw - static_cast<double>(coded)) / raw;
 }
 
-bool BMP2BarchConverter0::all_blacks(barchdata::const_iterator begin,
-                                     barchdata::const_iterator end)
+template <typename Kernel>
+size_t BMP2BarchConverter0::sampled_row_size(const unsigned char* row,
+                                             const unsigned char* above,
+                                             const size_t& width,
+                                             const PixelHuffman0* table,
+                                             barchdata& codes,
+                                             barchdata& residual,
+                                             const Settings& settings) const
 {
-  while (begin < end) {
-    if (!is_black(*begin)) {
-      return false;
-    }
+  const auto row_size = [&](const unsigned char* src) {
+    Kernel::classify_row(src, width, codes.data());
 
-    begin++;
+    return table != nullptr
+               ? Kernel::encoded_size(src, codes.data(), width, *table)
+               : Kernel::encoded_size(codes.data(), width);
+  };
+
+  if (row_fills(settings.format) && uniform_row(row, width) != row_raw) {
+    return 0U;
   }
 
-  return true;
+  if (row_refs(settings.format) && above != nullptr &&
+      std::memcmp(row, above, width) == 0) {
+    return 0U;
+  }
+
+  size_t size = std::min(row_size(row), width);
+
+  if (row_predicts(settings.format) && above != nullptr) {
+    xnor_rows(row, above, width, residual.data());
+
+    size = std::min(size, row_size(residual.data()));
+  }
+
+  return size;
 }
 
-bool BMP2BarchConverter0::all_whites(barchdata::const_iterator begin,
-                                     barchdata::const_iterator end)
+unsigned int BMP2BarchConverter0::quantize_rows(
+    const unsigned char* pixels, const size_t& width, const size_t& begin,
+    const size_t& end, const Quantization& quantization, unsigned char* dst)
 {
-  while (begin < end) {
-    if (!is_white(*begin)) {
-      return false;
+  constexpr const unsigned char white = codec_kernel::white;
+  constexpr const unsigned char black = codec_kernel::black;
+
+  // The darkest snapped white and the brightest snapped black
+  unsigned char darkest = white;
+  unsigned char brightest = black;
+
+  for (size_t iter = begin * width; iter < end * width; ++iter) {
+    const unsigned char pix = pixels[iter];
+
+    if (pix >= quantization.whites_from) {
+      darkest = std::min(darkest, pix);
+      dst[iter] = white;
+    } else if (pix <= quantization.blacks_to) {
+      brightest = std::max(brightest, pix);
+      dst[iter] = black;
+    } else {
+      dst[iter] = pix;
     }
-
-    begin++;
   }
 
-  return true;
+  return std::max<unsigned int>(white - darkest, brightest - black);
 }
 
-barchdata BMP2BarchConverter0::huffman_compress(const barchdata& line)
+PixelHuffman0::counts BMP2BarchConverter0::count_as_is_pixels(
+    const unsigned char* pixels, const size_t& width, const size_t& height,
+    const std::vector<unsigned char>& codes, const Settings& settings) const
 {
-  barchdata comp;
+  PixelHuffman0::counts total{};
+  std::mutex totalm;
 
-  comp.reserve(line.size());
+  const size_t groups = codec_kernel_runs::groups_count(width);
+  const size_t batch = codec_kernel_runs::batch_pixels;
 
-  barchdata::const_iterator liter = line.cbegin();
-  unsigned char dst = zero;
-  unsigned char dst_left = ucharbits;
+  for_rows(height, width, [&](size_t begin, size_t end) {
+    PixelHuffman0::counts local{};
 
-  while (liter < line.cend()) {
-    barchdata::const_iterator enditer =
-        std::distance(liter, line.cend()) >= get_batch_pixels_compress()
-            ? (liter + get_batch_pixels_compress())
-            : line.cend();
+    barchdata kinds = memory::BufferPool::acquire_from(mpool, groups);
+    barchdata reskinds = memory::BufferPool::acquire_from(mpool, groups);
+    barchdata residual = memory::BufferPool::acquire_from(mpool, width);
 
-    auto ccodedline = get_encoded(liter, enditer, dst, dst_left);
+    kinds.resize(groups);
+    reskinds.resize(groups);
+    residual.resize(width);
 
-    if (!ccodedline.empty()) {
-      comp.insert(comp.end(), ccodedline.begin(), ccodedline.end());
-    }
+    for (size_t liter = begin; liter < end; ++liter) {
+      const unsigned char* src = pixels + liter * width;
+
+      // The repeated and the uniform rows code no pixels
+      if (codes[liter] != row_raw || uniform_row(src, width) != row_raw) {
+        continue;
+      }
+
+      codec_kernel_runs::classify_row(src, width, kinds.data());
+
+      const unsigned char* srckinds = kinds.data();
 
-    if (dst_left == zero) {
-      LOGT("Packing byte " << std::bitset<ucharbits>(dst)
-                           << " with no data left");
-      comp.push_back(dst);
-      dst = zero;
-      dst_left = ucharbits;
+      // The variant with the fewer as-is groups is the likely one to be
+      // coded: the plain row or the residual
+      if (row_predicts(settings.format) && liter > 0U) {
+        xnor_rows(src, src - width, width, residual.data());
+        codec_kernel_runs::classify_row(residual.data(), width,
+                                        reskinds.data());
+
+        const auto mixed = [groups](const unsigned char* rowkinds) {
+          return std::count(rowkinds, rowkinds + groups,
+                            codec_kernel_runs::kind_mixed);
+        };
+
+        if (mixed(reskinds.data()) < mixed(kinds.data())) {
+          src = residual.data();
+          srckinds = reskinds.data();
+        }
+      }
+
+      for (size_t group = 0U; group < groups; ++group) {
+        if (srckinds[group] != codec_kernel_runs::kind_mixed) {
+          continue;
+        }
+
+        for (size_t pix = 0U; pix < batch; ++pix) {
+          ++local[src[group * batch + pix]];
+        }
+      }
+
+      for (size_t col = groups * batch; col < width; ++col) {
+        ++local[src[col]];
+      }
     }
 
-    liter = enditer;
-  }
+    memory::BufferPool::release_to(mpool, std::move(kinds));
+    memory::BufferPool::release_to(mpool, std::move(reskinds));
+    memory::BufferPool::release_to(mpool, std::move(residual));
 
-  if (dst_left > zero && dst_left < ucharbits) {
-    dst <<= dst_left;
-    LOGT("Packing last byte " << std::bitset<ucharbits>(dst) << " with "
-                              << static_cast<unsigned int>(dst_left)
-                              << " trailing bits");
-    comp.push_back(dst);
-  }
+    std::lock_guard<std::mutex> guard{totalm};
 
-  return comp;
+    for (size_t value = 0U; value < PixelHuffman0::symbols; ++value) {
+      total[value] += local[value];
+    }
+  });
+
+  return total;
 }
 
-barchdata BMP2BarchConverter0::get_encoded(barchdata::const_iterator begin,
-                                           barchdata::const_iterator end,
-                                           unsigned char& dst,
-                                           unsigned char& dst_left)
+void BMP2BarchConverter0::find_repeated_rows(const unsigned char* pixels,
+                                             const size_t& width,
+                                             const size_t& height,
+                                             std::vector<unsigned char>& codes)
 {
-  LOGT("Iters distance: " << std::distance(begin, end));
+  std::vector<uint64_t> hashes(height, 0U);
 
-  assert(std::distance(begin, end) <= get_batch_pixels_compress());
+  for_rows(height, width, [&](size_t begin, size_t end) {
+    for (size_t liter = begin; liter < end; ++liter) {
+      hashes[liter] = row_hash(pixels + liter * width, width);
+    }
+  });
 
-  if (std::distance(begin, end) < get_batch_pixels_compress()) {
-    LOGT("Compressing as is for unsuficient data "
-         << std::distance(begin, end));
-    return get_encoded_as_is(begin, end, dst, dst_left);
-  } else if (all_whites(begin, end)) {
-    return get_encoded_whites(dst, dst_left);
-  } else if (all_blacks(begin, end)) {
-    return get_encoded_blacks(dst, dst_left);
-  } else {
-    return get_encoded_as_is(begin, end, dst, dst_left);
-  }
+  for (size_t liter = 1U; liter < height; ++liter) {
+    const unsigned char* const rowb = pixels + liter * width;
 
-  return {};
+    for (size_t ref = 1U; ref <= row_ref_window && ref <= liter; ++ref) {
+      if (hashes[liter] == hashes[liter - ref] &&
+          std::memcmp(rowb, rowb - ref * width, width) == 0) {
+        codes[liter] = static_cast<unsigned char>(row_reference | (ref - 1U));
+        break;
+      }
+    }
+  }
 }
 
-barchdata BMP2BarchConverter0::get_encoded_as_is(
-    barchdata::const_iterator begin, barchdata::const_iterator end,
-    unsigned char& dst, unsigned char& dst_left)
+uint64_t BMP2BarchConverter0::row_hash(const unsigned char* row,
+                                       const size_t& width)
 {
-  LOGT("Coding as is");
-
-  static const unsigned char bitsRequired =
-      get_batch_pixels_compress() * ucharbits;
+  static constexpr const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
 
-  barchdata rt;
+  uint64_t hash = width;
+  size_t iter = 0U;
 
-  unsigned char data = coded_as_is_left;
-  unsigned char data_left = coded_as_is_bits;
+  for (; iter + sizeof(uint64_t) <= width; iter += sizeof(uint64_t)) {
+    uint64_t word = 0U;
 
-  while (data_left > 0) {
-    pack_left_bits(dst, dst_left, data, data_left);
+    std::memcpy(&word, row + iter, sizeof(uint64_t));
 
-    if (dst_left == zero) {
-      rt.push_back(dst);
-      dst = zero;
-      dst_left = ucharbits;
-    }
+    hash = (hash ^ word) * multiplier;
+    hash ^= hash >> 32U;
   }
 
-  data = *begin;
-  data_left = ucharbits;
-  unsigned char bitspacked = zero;
-
-  while (begin < end) {
-    pack_left_bits(dst, dst_left, data, data_left);
+  for (; iter < width; ++iter) {
+    hash = (hash ^ row[iter]) * multiplier;
+  }
 
-    if (data_left == zero) {
-      bitspacked += ucharbits;
-      begin++;
-      if (begin < end) {
-        LOGT("No data left");
-        data_left = ucharbits;
-        data = *begin;
-      }
-    }
+  return hash ^ (hash >> 29U);
+}
 
-    if (dst_left == zero) {
-      rt.push_back(dst);
-      dst = zero;
-      dst_left = ucharbits;
-    }
+unsigned char BMP2BarchConverter0::uniform_row(const unsigned char* row,
+                                               const size_t& width)
+{
+  const unsigned char first = row[0];
 
-    LOGT("already packed bits: " << static_cast<unsigned>(bitspacked));
+  if (first != codec_kernel::white && first != codec_kernel::black) {
+    return row_raw;
   }
 
-  if (dst_left > zero && dst_left < ucharbits && bitspacked < bitsRequired) {
-    bitspacked += dst_left;
-    dst <<= dst_left;
-    LOGT("Packing last byte " << std::bitset<ucharbits>(dst) << " with "
-                              << static_cast<unsigned int>(dst_left)
-                              << " trailing bits");
-    rt.push_back(dst);
-    dst = zero;
-    dst_left = ucharbits;
+  if (std::find_if(row + 1, row + width, [first](const unsigned char& pix) {
+        return pix != first;
+      }) != row + width) {
+    return row_raw;
   }
 
-  while (bitspacked < bitsRequired) {
-    LOGT("Packing trailing zero byte");
-    rt.push_back(zero);
-    bitspacked += ucharbits;
-    dst = zero;
-    dst_left = ucharbits;
-    LOGT("already packed bits: " << static_cast<unsigned>(bitspacked));
+  return first == codec_kernel::white ? row_whites : row_blacks;
+}
+
+void BMP2BarchConverter0::format(const BarchFormat& nformat)
+{
+  update([&nformat](Settings& settings) { settings.format = nformat; });
+}
+
+BarchFormat BMP2BarchConverter0::format() const { return snapshot()->format; }
+
+bool BMP2BarchConverter0::quantization(const Quantization& nquantization)
+{
+  if (!nquantization.valid()) {
+    LOGE("The white and black quantization ranges overlap: "
+         << static_cast<unsigned int>(nquantization.blacks_to) << " and "
+         << static_cast<unsigned int>(nquantization.whites_from));
+    return false;
   }
 
-  LOGT("total packed bits: " << static_cast<unsigned>(bitspacked) << "/"
-                             << static_cast<unsigned>(bitsRequired));
+  update([&nquantization](Settings& settings) {
+    settings.quantization = nquantization;
+  });
+
+  return true;
+}
 
-  return rt;
+Quantization BMP2BarchConverter0::quantization() const
+{
+  return snapshot()->quantization;
 }
 
-barchdata BMP2BarchConverter0::get_encoded_blacks(unsigned char& dst,
-                                                  unsigned char& dst_left)
+void BMP2BarchConverter0::preset(const EncoderPreset& npreset)
 {
-  assert(dst_left > zero);
+  update([&npreset](Settings& settings) {
+    switch (npreset) {
+      case EncoderPreset::fast:
+        settings.format = BarchFormat::ba000;
+        settings.decision = CompressDecision::runs_threshold;
+        break;
+      case EncoderPreset::balanced:
+        settings.format = BarchFormat::ba000;
+        settings.decision = CompressDecision::exact_size;
+        break;
+      case EncoderPreset::max_ratio:
+        settings.format = BarchFormat::ba005;
+        settings.decision = CompressDecision::exact_size;
+        break;
+    }
+  });
+}
 
-  LOGT("Coding as blacks");
+void BMP2BarchConverter0::thumbnail_rows(const unsigned char* pixels,
+                                         const size_t& width,
+                                         const size_t& height,
+                                         const size_t& scale,
+                                         const size_t& begin,
+                                         const size_t& end, unsigned char* dst)
+{
+  const size_t twidth = (width + scale - 1U) / scale;
 
-  unsigned char data = coded_blacks_left;
-  unsigned char data_left = coded_blacks_bits;
+  for (size_t trow = begin; trow < end; ++trow) {
+    const size_t rows = std::min(scale, height - trow * scale);
 
-  barchdata rt;
+    for (size_t tcol = 0U; tcol < twidth; ++tcol) {
+      const size_t cols = std::min(scale, width - tcol * scale);
+      const unsigned char* block =
+          pixels + trow * scale * width + tcol * scale;
+      size_t sum = 0U;
 
-  while (data_left > 0) {
-    pack_left_bits(dst, dst_left, data, data_left);
+      for (size_t row = 0U; row < rows; ++row, block += width) {
+        for (size_t col = 0U; col < cols; ++col) {
+          sum += block[col];
+        }
+      }
 
-    if (dst_left == zero) {
-      rt.push_back(dst);
-      dst = 0;
-      dst_left = ucharbits;
+      const size_t count = rows * cols;
+
+      dst[trow * twidth + tcol] =
+          static_cast<unsigned char>((sum + count / 2U) / count);
     }
   }
+}
+
+void BMP2BarchConverter0::thumbnail_side(const size_t& nside)
+{
+  update([&nside](Settings& settings) {
+    settings.thumbnail_side = std::min(nside, max_thumbnail_side);
+  });
+}
+
+size_t BMP2BarchConverter0::thumbnail_side() const
+{
+  return snapshot()->thumbnail_side;
+}
+
+void BMP2BarchConverter0::min_sampled_saving(const double& nsaving)
+{
+  update([&nsaving](Settings& settings) { settings.min_saving = nsaving; });
+}
+
+double BMP2BarchConverter0::min_sampled_saving() const
+{
+  return snapshot()->min_saving;
+}
+
+void BMP2BarchConverter0::decision(const CompressDecision& ndecision)
+{
+  update([&ndecision](Settings& settings) { settings.decision = ndecision; });
+}
 
-  return rt;
+BMP2BarchConverter0::CompressDecision BMP2BarchConverter0::decision() const
+{
+  return snapshot()->decision;
 }
 
-barchdata BMP2BarchConverter0::get_encoded_whites(unsigned char& dst,
-                                                  unsigned char& dst_left)
+BMP2BarchConverter0::SettingsPtr BMP2BarchConverter0::snapshot() const
 {
-  assert(dst_left > zero);
+  std::lock_guard<std::mutex> guard{msettingsm};
 
-  LOGT("Coding as whites");
+  return msettings;
+}
 
-  unsigned char data = coded_whites;
-  unsigned char data_left = coded_whites_bits;
+void BMP2BarchConverter0::update(
+    const std::function<void(Settings&)>& change)
+{
+  std::lock_guard<std::mutex> guard{msettingsm};
 
-  pack_left_bits(dst, dst_left, data, data_left);
+  // The conversions in flight keep the previous snapshot
+  auto changed = std::make_shared<Settings>(*msettings);
 
-  return {};
+  change(*changed);
+  msettings = std::move(changed);
 }
 
 }  // namespace barchclib0::converters
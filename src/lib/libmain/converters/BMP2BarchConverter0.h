@@ -1,10 +1,15 @@
 #ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMP2BARCHCONVERTER0_CLASS_H
 #define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMP2BARCHCONVERTER0_CLASS_H
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#include "EncoderPreset.h"
 #include "IBarchImage.h"
+#include "Quantization.h"
 #include "src/lib/libmain/converters/BMPAndBarchConverter0Base.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
@@ -22,40 +27,150 @@ class BMP2BarchConverter0
  public:
   using BMP2BarchConverter0Ptr = std::shared_ptr<BMP2BarchConverter0>;
 
+  /// @brief The rule of the per-row compression decision
+  enum class CompressDecision
+  {
+    /// @brief The v.0 rule: at least 2 runs of 4 whites or 4 blacks
+    runs_threshold,
+    /// @brief Only the rows the encoding makes smaller than the raw pixels
+    exact_size
+  };
+
+  /**
+   * @brief The encoding settings. Every conversion takes the snapshot of
+   * them at its start, so the setters never change a conversion in flight.
+   */
+  struct Settings
+  {
+    CompressDecision decision{CompressDecision::exact_size};
+    BarchFormat format{BarchFormat::ba000};
+    Quantization quantization;
+    double min_saving{1.0 / 32.0};
+    size_t thumbnail_side{0U};
+  };
+
+  using SettingsPtr = std::shared_ptr<const Settings>;
+
   virtual ~BMP2BarchConverter0() = default;
   BMP2BarchConverter0() = default;
 
   virtual BarchImagePtr convert(BMPImagePtr bmp);
 
+  /// @brief To be set before the conversions start. The exact size default.
+  virtual void decision(const CompressDecision& ndecision);
+  virtual CompressDecision decision() const;
+
+  /// @brief The format variant of the produced images, BA000 by default
+  virtual void format(const BarchFormat& nformat);
+  virtual BarchFormat format() const;
+
+  /**
+   * @brief The lossy snapping of the near-white and near-black pixels,
+   * lossless by default. The invalid thresholds are rejected.
+   */
+  virtual bool quantization(const Quantization& nquantization);
+  virtual Quantization quantization() const;
+
+  /// @brief Sets the format variant and the decision of the profile
+  virtual void preset(const EncoderPreset& npreset);
+
+  /**
+   * @brief The least share of the raw size the sampled rows must save. The
+   * images predicted to save less are stored with the raw rows without the
+   * full rows analysis. Zero turns the sampling off.
+   */
+  virtual void min_sampled_saving(const double& nsaving);
+  virtual double min_sampled_saving() const;
+
+  /**
+   * @brief The longest side of the preview embedded into the produced
+   * images, up to the max_thumbnail_side. Zero (default) embeds none.
+   */
+  virtual void thumbnail_side(const size_t& nside);
+  virtual size_t thumbnail_side() const;
+
+  /// @brief The rows the incompressibility is predicted from
+  inline static constexpr const size_t sampled_rows = 32U;
+
   static BMP2BarchConverter0Ptr create();
 
  private:
-  bool optimal_to_compress(BMPImagePtr image, const size_t& rowIndex);
-
-  static bool is_white(const PixelPtr& pix);
-  static bool is_black(const PixelPtr& pix);
-  static bool is_white(const unsigned char& val);
-  static bool is_black(const unsigned char& val);
-
-  static bool all_blacks(barchdata::const_iterator begin,
-                         barchdata::const_iterator end);
-  static bool all_whites(barchdata::const_iterator begin,
-                         barchdata::const_iterator end);
-
-  std::vector<bool> analyze_lines(BMPImagePtr image);
-
-  barchdata huffman_compress(const barchdata& line);
-
-  barchdata get_encoded(barchdata::const_iterator begin,
-                        barchdata::const_iterator end, unsigned char& dst,
-                        unsigned char& dst_left);
-  barchdata get_encoded_as_is(barchdata::const_iterator begin,
-                              barchdata::const_iterator end, unsigned char& dst,
-                              unsigned char& dst_left);
-  static barchdata get_encoded_blacks(unsigned char& dst,
-                                      unsigned char& dst_left);
-  static barchdata get_encoded_whites(unsigned char& dst,
-                                      unsigned char& dst_left);
+  /**
+   * @brief Encodes the [begin, end) rows with the format kernel. The
+   * compressed flags take the rows table codes. The as-is pixels are coded
+   * with the table, if any.
+   */
+  template <typename Kernel>
+  void compress_rows(const unsigned char* pixels, const size_t& width,
+                     const size_t& begin, const size_t& end,
+                     std::vector<unsigned char>& compressed,
+                     barchscans& lines, const PixelHuffman0* table,
+                     const Settings& settings) const;
+
+  /**
+   * @brief The share of the raw size the evenly spread sampled rows save
+   * with the format coding
+   */
+  double sampled_saving(const unsigned char* pixels, const size_t& width,
+                        const size_t& height, const Settings& settings) const;
+
+  /// @brief The coded size of the single row with the Kernel, raw at most
+  template <typename Kernel>
+  size_t sampled_row_size(const unsigned char* row, const unsigned char* above,
+                          const size_t& width, const PixelHuffman0* table,
+                          barchdata& codes, barchdata& residual,
+                          const Settings& settings) const;
+
+  /**
+   * @brief The pixel counts of the as-is groups the rows are likely coded
+   * with, the Huffman table is built of
+   */
+  PixelHuffman0::counts count_as_is_pixels(
+      const unsigned char* pixels, const size_t& width, const size_t& height,
+      const std::vector<unsigned char>& codes, const Settings& settings) const;
+
+  /**
+   * @brief Marks the rows identical to one of the row_ref_window rows above
+   * with the row_reference codes. The rows are compared by the hash first.
+   */
+  static void find_repeated_rows(const unsigned char* pixels,
+                                 const size_t& width, const size_t& height,
+                                 std::vector<unsigned char>& codes);
+
+  /**
+   * @brief Snaps the near-white and near-black pixels of the [begin, end)
+   * rows into the dst. Returns the largest pixel change.
+   */
+  static unsigned int quantize_rows(const unsigned char* pixels,
+                                    const size_t& width, const size_t& begin,
+                                    const size_t& end,
+                                    const Quantization& quantization,
+                                    unsigned char* dst);
+
+  /**
+   * @brief Averages the scale x scale blocks of the pixels into the [begin,
+   * end) rows of the twidth wide preview. The edge blocks are clipped.
+   */
+  static void thumbnail_rows(const unsigned char* pixels, const size_t& width,
+                             const size_t& height, const size_t& scale,
+                             const size_t& begin, const size_t& end,
+                             unsigned char* dst);
+
+  /// @brief The fast non-cryptographic hash of the row pixels
+  static uint64_t row_hash(const unsigned char* row, const size_t& width);
+
+  /// @brief The row_whites or row_blacks code of the uniform row, row_raw else
+  static unsigned char uniform_row(const unsigned char* row,
+                                   const size_t& width);
+
+  /// @brief The current settings snapshot
+  SettingsPtr snapshot() const;
+
+  /// @brief Replaces the snapshot with its changed copy
+  void update(const std::function<void(Settings&)>& change);
+
+  mutable std::mutex msettingsm;
+  SettingsPtr msettings{std::make_shared<const Settings>()};
 };
 
 using BMP2BarchConverter0Ptr = BMP2BarchConverter0::BMP2BarchConverter0Ptr;
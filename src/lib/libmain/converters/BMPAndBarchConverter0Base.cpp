@@ -1,5 +1,6 @@
 #include "src/lib/libmain/converters/BMPAndBarchConverter0Base.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <exception>
@@ -7,6 +8,7 @@
 #include <vector>
 
 #include "IBarchImage.h"
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
 #include "src/log/log.h"
@@ -43,6 +45,71 @@ const unsigned int& BMPAndBarchConverter0Base::get_supported_bits()
   return supported_bits;
 }
 
+const char* BMPAndBarchConverter0Base::starter(const BarchFormat& format)
+{
+  switch (format) {
+    case BarchFormat::ba001:
+      return BARCH1_STARTER;
+    case BarchFormat::ba002:
+      return BARCH2_STARTER;
+    case BarchFormat::ba003:
+      return BARCH3_STARTER;
+    case BarchFormat::ba004:
+      return BARCH4_STARTER;
+    case BarchFormat::ba005:
+      return BARCH5_STARTER;
+    case BarchFormat::ba000:
+    default:
+      return BARCH0_STARTER;
+  }
+}
+
+bool BMPAndBarchConverter0Base::long_runs(const BarchFormat& format)
+{
+  return format != BarchFormat::ba000;
+}
+
+bool BMPAndBarchConverter0Base::row_fills(const BarchFormat& format)
+{
+  return format == BarchFormat::ba002 || row_refs(format);
+}
+
+bool BMPAndBarchConverter0Base::row_refs(const BarchFormat& format)
+{
+  return format == BarchFormat::ba003 || row_predicts(format);
+}
+
+bool BMPAndBarchConverter0Base::row_predicts(const BarchFormat& format)
+{
+  return format == BarchFormat::ba004 || entropy_coded(format);
+}
+
+bool BMPAndBarchConverter0Base::entropy_coded(const BarchFormat& format)
+{
+  return format == BarchFormat::ba005;
+}
+
+void BMPAndBarchConverter0Base::xnor_rows(const unsigned char* src,
+                                          const unsigned char* above,
+                                          const size_t& width,
+                                          unsigned char* dst)
+{
+  for (size_t iter = 0U; iter < width; ++iter) {
+    dst[iter] = static_cast<unsigned char>(~(src[iter] ^ above[iter]));
+  }
+}
+
+unsigned int BMPAndBarchConverter0Base::table_code_bits(
+    const BarchFormat& format)
+{
+  return row_refs(format) ? 4U : row_fills(format) ? 2U : 1U;
+}
+
+void BMPAndBarchConverter0Base::pool(const memory::BufferPoolPtr& npool)
+{
+  mpool = npool;
+}
+
 void BMPAndBarchConverter0Base::pack_left_bits(unsigned char& dst,
                                                unsigned char& dst_left,
                                                unsigned char& data,
@@ -82,6 +149,28 @@ void BMPAndBarchConverter0Base::pack_left_bits(unsigned char& dst,
                   << static_cast<unsigned int>(data_left));
 }
 
+void BMPAndBarchConverter0Base::for_rows(
+    const size_t& rows, const size_t& width,
+    const std::function<void(size_t, size_t)>& body,
+    executor::WorkStealingScheduler* fallback)
+{
+  auto* scheduler = executor::WorkStealingScheduler::current();
+
+  if (scheduler == nullptr) {
+    scheduler = fallback;
+  }
+
+  const size_t grain =
+      std::max<size_t>(1U, rows_task_pixels / std::max<size_t>(1U, width));
+
+  if (scheduler == nullptr || rows <= grain) {
+    body(0U, rows);
+    return;
+  }
+
+  scheduler->parallel_for(0U, rows, grain, body);
+}
+
 int BMPAndBarchConverter0Base::get_next_pack_type(
     barchdata::const_iterator& liter, barchdata::const_iterator lend,
     unsigned char& cc, unsigned char& ccount)
@@ -1,9 +1,15 @@
 #ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMPANDBARCHCONVERTER0BASE_CLASS_H
 #define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMPANDBARCHCONVERTER0BASE_CLASS_H
 
+#include <cstddef>
+#include <functional>
+
 #include "IBarchImage.h"
+#include "src/lib/libmain/converters/CodecKernel0.h"
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
+#include "src/lib/libmain/memory/BufferPool.h"
 
 namespace barchclib0::converters
 {
@@ -22,7 +28,14 @@ class BMPAndBarchConverter0Base
   virtual const unsigned int& get_batch_pixels_compress();
   virtual const unsigned int& get_supported_bits();
 
+  /// @brief The pool for the row and pixel buffers, none by default
+  virtual void pool(const memory::BufferPoolPtr& npool);
+
  protected:
+  /// @brief The compile-time codec cores of the BA000 and BA001 formats
+  using codec_kernel = CodecKernel0<4U, 8U, 2U>;
+  using codec_kernel_runs = CodecKernel0<4U, 8U, 2U, true>;
+
   int get_next_pack_type(barchdata::const_iterator& liter,
                          barchdata::const_iterator lend, unsigned char& cc,
                          unsigned char& ccount);
@@ -34,29 +47,110 @@ class BMPAndBarchConverter0Base
   inline static constexpr const unsigned char ucharbits =
       sizeof(unsigned char) * 8;
 
-  static constexpr const unsigned char coded_whites = zero;
-  static constexpr const unsigned char coded_whites_bits = 1U;
+  static constexpr const unsigned char coded_whites =
+      codec_kernel::coded_whites;
+  static constexpr const unsigned char coded_whites_bits =
+      codec_kernel::coded_whites_bits;
 
-  static constexpr const unsigned char coded_blacks = 0B10;
-  static constexpr const unsigned char coded_blacks_bits = 2U;
+  static constexpr const unsigned char coded_blacks =
+      codec_kernel::coded_blacks;
+  static constexpr const unsigned char coded_blacks_bits =
+      codec_kernel::coded_blacks_bits;
   static constexpr const unsigned char coded_blacks_left =
       coded_blacks << (ucharbits - coded_blacks_bits);
 
-  static constexpr const unsigned char coded_as_is = 0B11;
-  static constexpr const unsigned char coded_as_is_bits = 2U;
+  static constexpr const unsigned char coded_as_is = codec_kernel::coded_as_is;
+  static constexpr const unsigned char coded_as_is_bits =
+      codec_kernel::coded_as_is_bits;
   static constexpr const unsigned char coded_as_is_left =
       coded_as_is << (ucharbits - coded_as_is_bits);
 
   static void pack_left_bits(unsigned char& dst, unsigned char& dst_left,
                              unsigned char& data, unsigned char& data_left);
 
+  /**
+   * @brief Runs the body over the [0, rows) image rows range. On a scheduler
+   * worker the rows are split into the row-range tasks, elsewhere they go to
+   * the given scheduler, if any, or the body runs at once over the whole
+   * range.
+   */
+  static void for_rows(const size_t& rows, const size_t& width,
+                       const std::function<void(size_t, size_t)>& body,
+                       executor::WorkStealingScheduler* fallback = nullptr);
+
+  /// @brief The pixels count of a single row-range task
+  inline static constexpr const size_t rows_task_pixels = 1U << 18U;
+
   // for writers/readers
   inline static const char* const BARCH0_STARTER = "BA000";
+  inline static const char* const BARCH1_STARTER = "BA001";
+  inline static const char* const BARCH2_STARTER = "BA002";
+  inline static const char* const BARCH3_STARTER = "BA003";
+  inline static const char* const BARCH4_STARTER = "BA004";
+  inline static const char* const BARCH5_STARTER = "BA005";
+
+  /// @brief The file starter of the format variant
+  static const char* starter(const BarchFormat& format);
+
+  // The optional thumbnail section follows the image dimensions. The files
+  // carrying it have the thumbnail_mark in place of the second starter
+  // char, the section holds the 1 byte width, the 1 byte height and the raw
+  // grayscale pixels of the preview row by row.
+  inline static constexpr const char thumbnail_mark = 'T';
+  inline static constexpr const size_t thumbnail_mark_at = 1U;
+  /// @brief The starter and the 32 bit width and height go before it
+  inline static constexpr const size_t thumbnail_offset = 5U + 4U + 4U;
+  inline static constexpr const size_t max_thumbnail_side = 255U;
+
+  /// @brief The variant rows are coded with the codec_kernel_runs
+  static bool long_runs(const BarchFormat& format);
+
+  /// @brief The variant rows table marks the uniform rows without payload
+  static bool row_fills(const BarchFormat& format);
+
+  /// @brief The variant rows table marks the repeated rows without payload
+  static bool row_refs(const BarchFormat& format);
+
+  /// @brief The variant rows may be predicted from the row above
+  static bool row_predicts(const BarchFormat& format);
+
+  /// @brief The variant as-is pixels are coded with the per-image Huffman
+  static bool entropy_coded(const BarchFormat& format);
+
+  /**
+   * @brief The vertical predictor: dst = ~(src ^ above). The same call makes
+   * the residual of the row and restores the row from the residual, the
+   * dst may be the src.
+   */
+  static void xnor_rows(const unsigned char* src, const unsigned char* above,
+                        const size_t& width, unsigned char* dst);
+
+  /// @brief The bits per row of the variant rows table
+  static unsigned int table_code_bits(const BarchFormat& format);
+
+  // The rows table codes: 1 bit raw or compressed, the row_fills variants
+  // add the uniform rows, the row_refs variants add the references and the
+  // row_predicts variants add the predicted rows
+  inline static constexpr const unsigned char row_raw = 0B00;
+  inline static constexpr const unsigned char row_compressed = 0B01;
+  inline static constexpr const unsigned char row_whites = 0B10;
+  inline static constexpr const unsigned char row_blacks = 0B11;
+  /// @brief The compressed residual against the row above
+  inline static constexpr const unsigned char row_predicted = 0B0101;
+  /// @brief The low bits keep the distance to the referenced row minus one
+  inline static constexpr const unsigned char row_reference = 0B1000;
+  inline static constexpr const unsigned char row_ref_mask = 0B0111;
+  inline static constexpr const size_t row_ref_window = row_ref_mask + 1U;
+
+  memory::BufferPoolPtr mpool;
 
  private:
-  inline static const unsigned int supported_bits = 8U;
-  inline static const unsigned int batch_pixels_compress = 4U;
-  inline static const unsigned int min_opt_2_compress = 2U;
+  inline static const unsigned int supported_bits =
+      codec_kernel::bits_per_pixel;
+  inline static const unsigned int batch_pixels_compress =
+      codec_kernel::batch_pixels;
+  inline static const unsigned int min_opt_2_compress =
+      codec_kernel::min_opt_2_compress;
 };
 
 }  // namespace barchclib0::converters
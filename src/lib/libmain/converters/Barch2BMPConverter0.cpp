@@ -1,9 +1,11 @@
 #include "src/lib/libmain/converters/Barch2BMPConverter0.h"
 
-#include <bitset>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <exception>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "IBarchImage.h"
@@ -11,191 +13,374 @@
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
 #include "src/log/log.h"
+#include "src/log/trace.h"
 
 namespace barchclib0::converters
 {
 
 BMPImagePtr Barch2BMPConverter0::convert(BarchImagePtr barch)
 {
-  if (barch == nullptr) {
-    LOGE("Invalid image pointer provided");
+  if (!valid(barch)) {
     return {};
   }
 
-  if (barch->width() == 0 || barch->height() == 0) {
-    LOGE("Image with invalid size provided " << barch->width() << "x"
-                                             << barch->height());
+  TRACE_SPAN("codec", "Barch2BMPConverter0::decompress_lines");
+
+  const size_t width = barch->width();
+  const size_t height = barch->height();
+
+  auto bmp = BMPImage::create();
+
+  bmp->pool(mpool);
+  bmp->width(width);
+  bmp->bits_per_pixel(barch->bits_per_pixel());
+
+  barchdata pixels = memory::BufferPool::acquire_from(mpool, width * height);
+
+  pixels.resize(width * height);
+
+  if (!decode(*barch, pixels.data(), width, RowOrder::top_down,
+              DecodeRegion{0U, height, 0U, width}, 1U)) {
+    memory::BufferPool::release_to(mpool, std::move(pixels));
     return {};
   }
 
-  if (barch->data().empty()) {
-    LOGE("Image with invalid data buffer provided");
-    return {};
+  bmp->data(std::move(pixels));
+  bmp->height(height);
+
+  return bmp;
+}
+
+bool Barch2BMPConverter0::convert(BarchImagePtr barch,
+                                  const DecodeTarget& target,
+                                  const DecodeRegion& region)
+{
+  if (!valid(barch)) {
+    return false;
   }
 
-  if (!supported_bits_per_color(barch->bits_per_pixel())) {
-    LOGE("Multicolor BGR images are not supported");
-    return {};
+  const size_t width = barch->width();
+  const size_t height = barch->height();
+
+  DecodeRegion area = region;
+
+  area.rows = area.rows == 0U && area.row < height ? height - area.row
+                                                   : area.rows;
+  area.cols = area.cols == 0U && area.col < width ? width - area.col
+                                                  : area.cols;
+
+  if (area.rows == 0U || area.cols == 0U || area.row + area.rows > height ||
+      area.col + area.cols > width) {
+    LOGE("The region " << area.cols << "x" << area.rows << " at " << area.col
+                       << "," << area.row << " is out of the image " << width
+                       << "x" << height);
+    return false;
   }
 
-  const auto& linestable = barch->lines_table();
+  if (target.pixels == nullptr) {
+    LOGE("No target buffer provided");
+    return false;
+  }
 
-  if (linestable.size() != barch->height()) {
-    LOGE("Lines table (" << linestable.size() << ") missmatches image rows ("
-                         << barch->height() << ")");
+  if (target.stride < area.cols) {
+    LOGE("The target stride " << target.stride << " is less than the width "
+                              << area.cols);
+    return false;
+  }
+
+  if (target.size < target.stride * (area.rows - 1U) + area.cols) {
+    LOGE("The target buffer (" << target.size << ") is less than the region "
+                               << area.cols << "x" << area.rows
+                               << " with stride " << target.stride);
+    return false;
+  }
+
+  TRACE_SPAN("codec", "Barch2BMPConverter0::decompress_lines_into");
+
+  return decode(*barch, target.pixels, target.stride, target.order, area,
+                1U);
+}
+
+BMPImagePtr Barch2BMPConverter0::thumbnail(BarchImagePtr barch,
+                                           const size_t& scale)
+{
+  if (scale != 2U && scale != 4U && scale != 8U) {
+    LOGE("Unsupported thumbnail scale 1/" << scale);
+    return {};
+  }
+
+  if (!valid(barch)) {
     return {};
   }
 
+  TRACE_SPAN("codec", "Barch2BMPConverter0::thumbnail");
+
+  const size_t width = sampled_count(barch->width(), scale);
+  const size_t height = sampled_count(barch->height(), scale);
+
   auto bmp = BMPImage::create();
 
-  bmp->width(barch->width());
+  bmp->pool(mpool);
+  bmp->width(width);
   bmp->bits_per_pixel(barch->bits_per_pixel());
 
-  for (size_t liter = 0U; liter < barch->height() && liter < linestable.size();
-       ++liter) {
-    auto scanline = barch->line(liter);
+  barchdata pixels = memory::BufferPool::acquire_from(mpool, width * height);
 
-    if (linestable[liter]) {
-      scanline = huffman_decompress(scanline, barch->width());
-    }
+  pixels.resize(width * height);
 
-    bmp->append_line(scanline);
+  if (!decode(*barch, pixels.data(), width, RowOrder::top_down,
+              DecodeRegion{0U, barch->height(), 0U, barch->width()}, scale)) {
+    memory::BufferPool::release_to(mpool, std::move(pixels));
+    return {};
   }
 
+  bmp->data(std::move(pixels));
+  bmp->height(height);
+
   return bmp;
 }
 
-Barch2BMPConverter0Ptr Barch2BMPConverter0::create()
+bool Barch2BMPConverter0::valid(const BarchImagePtr& barch)
 {
-  return std::make_shared<Barch2BMPConverter0>();
-}
+  if (barch == nullptr) {
+    LOGE("Invalid image pointer provided");
+    return false;
+  }
 
-barchdata Barch2BMPConverter0::huffman_decompress(const barchdata& src,
-                                                  const size_t& width)
-{
-  static_assert(leftbit == 0B10000000);
-  static_assert(static_cast<unsigned char>(
-                    static_cast<unsigned char>(0B11000000) << 2) == zero);
-  static_assert(static_cast<unsigned char>(
-                    static_cast<unsigned char>(
-                        static_cast<unsigned char>(0B11000000) << 2) >>
-                    2) == zero);
-
-  barchdata rt;
-
-  rt.reserve(width);
-
-  for (barchdata::const_iterator liter = src.cbegin();
-       liter < src.cend() && rt.size() < width; ++liter) {
-    unsigned char cc = *liter;
-    unsigned char ccount = ucharbits;
-
-    while (ccount > 0 && rt.size() < width && liter < src.cend()) {
-      LOGT("checking " << std::bitset<ucharbits>(cc) << ") with left "
-                       << static_cast<unsigned int>(ccount));
-      const int itype = get_next_pack_type(liter, src.end(), cc, ccount);
-
-      if (itype < 0) {
-        LOGT("End of data reached");
-        return rt;
-      }
+  if (barch->width() == 0 || barch->height() == 0) {
+    LOGE("Image with invalid size provided " << barch->width() << "x"
+                                             << barch->height());
+    return false;
+  }
 
-      const unsigned char type = static_cast<unsigned char>(itype);
+  const auto& scans = barch->scanlines();
 
-      if (type == coded_whites) {
-        fill_whites(rt, width);
-      } else if (type == coded_blacks) {
-        fill_blacks(rt, width);
-      } else if (type == coded_as_is) {
-        copy_arbitrary(rt, width, liter, src.cend(), cc, ccount);
-      }
+  if (std::all_of(scans.cbegin(), scans.cend(),
+                  [](const barchdata& scan) { return scan.empty(); }) &&
+      !barch->has_fills() && !barch->has_refs()) {
+    LOGE("Image with invalid data buffer provided");
+    return false;
+  }
+
+  if (!supported_bits_per_color(barch->bits_per_pixel())) {
+    LOGE("Multicolor BGR images are not supported");
+    return false;
+  }
+
+  const auto& linestable = barch->lines_table();
+
+  if (linestable.size() != barch->height()) {
+    LOGE("Lines table (" << linestable.size() << ") missmatches image rows ("
+                         << barch->height() << ")");
+    return false;
+  }
 
-      LOGT("result size " << rt.size());
+  for (size_t liter = 0U; liter < barch->height(); ++liter) {
+    if (barch->row_ref(liter) > liter) {
+      LOGE("The row " << liter << " refers above the image");
+      return false;
     }
   }
 
-  return rt;
+  if (barch->row_predicted(0U)) {
+    LOGE("The first row can't be predicted");
+    return false;
+  }
+
+  return true;
 }
 
-void Barch2BMPConverter0::fill_whites(barchdata& dst, const size_t& width)
+bool Barch2BMPConverter0::decode(const BarchImage& barch, unsigned char* dst,
+                                 const size_t& stride, const RowOrder& order,
+                                 const DecodeRegion& region,
+                                 const size_t& step)
 {
-  unsigned int wcount = zero;
+  PixelHuffman0 huffman;
+  const bool entropy = entropy_coded(barch.format());
 
-  while (wcount++ < get_batch_pixels_compress() && dst.size() < width) {
-    insert_white_pixel(dst);
+  if (entropy && !huffman.assign(barch.entropy_lengths().data(),
+                                 barch.entropy_lengths().size())) {
+    LOGE("Invalid code lengths table");
+    return false;
   }
-}
 
-void Barch2BMPConverter0::fill_blacks(barchdata& dst, const size_t& width)
-{
-  unsigned int bcount = zero;
+  const PixelHuffman0* const table = entropy ? &huffman : nullptr;
 
-  while (bcount++ < get_batch_pixels_compress() && dst.size() < width) {
-    insert_black_pixel(dst);
+  const size_t width = barch.width();
+  const size_t col = region.col;
+  const size_t end = region.row + region.rows;
+  const size_t outrows = sampled_count(region.rows, step);
+  const size_t outcols = sampled_count(region.cols, step);
+  const auto& linestable = barch.lines_table();
+
+  const auto output_row = [&](const size_t& row) {
+    return row >= region.row && (row - region.row) % step == 0U;
+  };
+
+  // The output rows and the rows above they are restored from: the
+  // references and the predictions point upwards only
+  std::vector<unsigned char> needed(end, 0U);
+
+  for (size_t liter = region.row; liter < end; liter += step) {
+    needed[liter] = 1U;
   }
-}
 
-void Barch2BMPConverter0::copy_arbitrary(barchdata& dst, const size_t& width,
-                                         barchdata::const_iterator& liter,
-                                         barchdata::const_iterator lend,
-                                         unsigned char& cc,
-                                         unsigned char& ccount)
-{
-  LOGT("Trying to fill arbitrary pixels");
+  size_t first = region.row;
+  bool restored = false;
 
-  assert(liter < lend);
+  for (size_t liter = end; liter-- > 0U;) {
+    if (needed[liter] == 0U) {
+      continue;
+    }
 
-  unsigned char bytes_inserted = zero;
+    first = liter;
+    restored = restored || !output_row(liter);
 
-  if (ccount == zero) {
-    liter++;
-    if (liter >= lend) {
-      LOGW("No data left");
-      return;
+    if (barch.row_ref(liter) != 0U) {
+      needed[liter - barch.row_ref(liter)] = 1U;
+    } else if (barch.row_predicted(liter)) {
+      needed[liter - 1U] = 1U;
     }
-    cc = *liter;
-    ccount = ucharbits;
   }
 
-  unsigned char data = zero;
-  unsigned char data_left = ucharbits;
+  // The rows only restored from are decoded into the own buffer
+  barchdata scratch;
 
-  while (liter < lend && dst.size() < width &&
-         bytes_inserted < get_batch_pixels_compress()) {
-    pack_left_bits(data, data_left, cc, ccount);
+  if (restored) {
+    scratch = memory::BufferPool::acquire_from(mpool, (end - first) * outcols);
+    scratch.resize((end - first) * outcols);
+  }
 
-    if (data_left == zero) {
-      dst.emplace_back(data);
-      data = zero;
-      data_left = ucharbits;
-      bytes_inserted++;
+  const auto row_at = [&](const size_t& row) {
+    if (!output_row(row)) {
+      return scratch.data() + (row - first) * outcols;
     }
 
-    if (ccount == zero) {
-      liter++;
-      cc = *liter;
-      ccount = ucharbits;
+    const size_t offset = (row - region.row) / step;
+
+    return dst + (order == RowOrder::top_down ? offset
+                                              : outrows - 1U - offset) *
+                     stride;
+  };
+
+  // The rows are decoded straight into their place, the short rows are
+  // zero filled. The whole rows go through the plain row decoding, the
+  // windows and the samples stop parsing past the last column.
+  const bool runs = long_runs(barch.format());
+  const bool whole = col == 0U && step == 1U && region.cols == width;
+  // Keeps the workers alive until the decoding is done
+  const executor::WorkStealingSchedulerPtr workers = scheduler();
+
+  const auto decode_rows = [&](size_t begin, size_t rend) {
+    for (size_t liter = first + begin; liter < first + rend; ++liter) {
+      if (needed[liter] == 0U || barch.row_ref(liter) != 0U) {
+        continue;
+      }
+
+      const barchdata& row = barch.scanline(liter);
+      unsigned char* const rowdst = row_at(liter);
+      const RowFill fill = barch.row_fill(liter);
+      size_t decoded = outcols;
+
+      if (fill != RowFill::none) {
+        std::memset(rowdst,
+                    fill == RowFill::whites ? codec_kernel::white
+                                            : codec_kernel::black,
+                    outcols);
+      } else if (!linestable[liter]) {
+        decoded = 0U;
+
+        for (size_t src = col; decoded < outcols && src < row.size();
+             src += step) {
+          rowdst[decoded++] = row[src];
+        }
+      } else if (whole) {
+        decoded = runs ? codec_kernel_runs::decode_row(row.data(), row.size(),
+                                                       rowdst, width, table)
+                       : codec_kernel::decode_row(row.data(), row.size(),
+                                                  rowdst, width);
+      } else {
+        decoded = runs ? codec_kernel_runs::decode_row_sampled(
+                             row.data(), row.size(), rowdst, col,
+                             col + region.cols, step, table)
+                       : codec_kernel::decode_row_sampled(
+                             row.data(), row.size(), rowdst, col,
+                             col + region.cols, step);
+      }
+
+      std::memset(rowdst + decoded, 0, outcols - decoded);
+    }
+  };
+
+  for_rows(end - first, width / step, decode_rows, workers.get());
+
+  // The repeated and the predicted rows depend on the rows above, so they
+  // are resolved in order once the rest is decoded: the predicted rows hold
+  // the decoded residual by now. The same columns are sampled in every row.
+  if (barch.has_refs() || barch.has_predicted()) {
+    for (size_t liter = std::max<size_t>(first, 1U); liter < end; ++liter) {
+      if (needed[liter] == 0U) {
+        continue;
+      }
+
+      unsigned char* const rowdst = row_at(liter);
+      const size_t ref = barch.row_ref(liter);
+
+      if (ref != 0U) {
+        std::memcpy(rowdst, row_at(liter - ref), outcols);
+      } else if (barch.row_predicted(liter)) {
+        xnor_rows(rowdst, row_at(liter - 1U), outcols, rowdst);
+      }
     }
   }
+
+  memory::BufferPool::release_to(mpool, std::move(scratch));
+
+  return true;
 }
 
-void Barch2BMPConverter0::insert_white_pixel(barchdata& dst)
+void Barch2BMPConverter0::threads(const size_t& nthreads)
 {
-  LOGT("fill whites");
+  executor::WorkStealingSchedulerPtr previous;
+
+  {
+    std::lock_guard<std::mutex> guard{mschedulerm};
 
-  insert_pixel(dst, two_five_five);
+    mthreads = nthreads;
+    previous = std::move(mscheduler);
+    mscheduler = nullptr;
+  }
+
+  // joins the previous workers, if no decoding holds them
+  previous.reset();
 }
 
-void Barch2BMPConverter0::insert_black_pixel(barchdata& dst)
+size_t Barch2BMPConverter0::threads() const
 {
-  LOGT("fill blacks");
+  std::lock_guard<std::mutex> guard{mschedulerm};
 
-  insert_pixel(dst, zero);
+  return mthreads;
 }
 
-void Barch2BMPConverter0::insert_pixel(barchdata& dst, const int& color)
+executor::WorkStealingSchedulerPtr Barch2BMPConverter0::scheduler()
 {
-  dst.emplace_back(color);
+  std::lock_guard<std::mutex> guard{mschedulerm};
+
+  if (mthreads == 1U) {
+    return {};
+  }
+
+  if (mscheduler == nullptr) {
+    LOGD("Starting the decoding workers");
+    mscheduler = executor::WorkStealingScheduler::create(mthreads);
+  }
+
+  return mscheduler;
+}
+
+Barch2BMPConverter0Ptr Barch2BMPConverter0::create()
+{
+  return std::make_shared<Barch2BMPConverter0>();
 }
 
 }  // namespace barchclib0::converters
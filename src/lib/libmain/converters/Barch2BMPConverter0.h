@@ -1,10 +1,14 @@
 #ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BARCH2BMPCONVERTER0_CLASS_H
 #define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BARCH2BMPCONVERTER0_CLASS_H
 
+#include <cstddef>
 #include <memory>
+#include <mutex>
 
+#include "DecodeTarget.h"
 #include "IBarchImage.h"
 #include "src/lib/libmain/converters/BMPAndBarchConverter0Base.h"
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
 
@@ -26,21 +30,59 @@ class Barch2BMPConverter0
 
   virtual BMPImagePtr convert(BarchImagePtr barch);
 
+  /**
+   * @brief Decodes the image region straight into the caller owned buffer,
+   * without the intermediate BMP image. Only the region rows and the rows
+   * above they are restored from are decoded, and only up to the region
+   * columns.
+   */
+  virtual bool convert(BarchImagePtr barch, const DecodeTarget& target,
+                       const DecodeRegion& region = {});
+
+  /**
+   * @brief Decodes the reduced image of every scale-th pixel of every
+   * scale-th row, the scale is 2, 4 or 8. The other rows are skipped unless
+   * the sampled rows are restored from them, the uniform groups are filled
+   * straight into the output pixels.
+   */
+  virtual BMPImagePtr thumbnail(BarchImagePtr barch, const size_t& scale);
+
+  /**
+   * @brief The decoding workers count of the calls made outside the
+   * scheduler workers. One (default) decodes on the calling thread, zero
+   * means the hardware concurrency. The workers are started on demand and
+   * shared by the calls.
+   */
+  virtual void threads(const size_t& nthreads);
+  virtual size_t threads() const;
+
   static Barch2BMPConverter0Ptr create();
 
  private:
-  barchdata huffman_decompress(const barchdata& src, const size_t& width);
-
-  void fill_whites(barchdata& dst, const size_t& width);
-  void fill_blacks(barchdata& dst, const size_t& width);
-  void copy_arbitrary(barchdata& dst, const size_t& width,
-                      barchdata::const_iterator& liter,
-                      barchdata::const_iterator lend, unsigned char& cc,
-                      unsigned char& ccount);
-
-  void insert_white_pixel(barchdata& dst);
-  void insert_black_pixel(barchdata& dst);
-  void insert_pixel(barchdata& dst, const int& color);
+  /// @brief Checks the image is consistent enough to be decoded
+  bool valid(const BarchImagePtr& barch);
+
+  /**
+   * @brief Decodes every step-th pixel of every step-th row of the region of
+   * the validated image, the output rows stride bytes apart
+   */
+  bool decode(const BarchImage& barch, unsigned char* dst,
+              const size_t& stride, const RowOrder& order,
+              const DecodeRegion& region, const size_t& step);
+
+  /// @brief The sampled pixels count of every step-th of the count
+  static constexpr size_t sampled_count(const size_t& count,
+                                        const size_t& step)
+  {
+    return (count + step - 1U) / step;
+  }
+
+  /// @brief The own workers, nullptr for the single thread decoding
+  executor::WorkStealingSchedulerPtr scheduler();
+
+  mutable std::mutex mschedulerm;
+  size_t mthreads{1U};
+  executor::WorkStealingSchedulerPtr mscheduler;
 };
 
 using Barch2BMPConverter0Ptr = Barch2BMPConverter0::Barch2BMPConverter0Ptr;
@@ -0,0 +1,240 @@
+#include "src/lib/libmain/converters/CodecDispatch.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "src/lib/libmain/converters/CodecKernel0.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BARCH_CODEC_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace barchclib0::converters
+{
+
+namespace
+{
+
+using kernel = CodecKernel0<4U, 8U>;
+
+static_assert(kernel::kind_whites == 0U && kernel::kind_blacks == 2U &&
+                  kernel::kind_mixed == 3U,
+              "The group kinds are computed arithmetically below");
+
+constexpr const size_t group = kernel::batch_pixels;
+
+void classify_scalar(const unsigned char* row, size_t groups,
+                     unsigned char* codes)
+{
+  for (size_t iter = 0U; iter < groups; ++iter, row += group) {
+    bool whites = true;
+    bool blacks = true;
+
+    for (size_t pix = 0U; pix < group; ++pix) {
+      whites = whites && row[pix] == kernel::white;
+      blacks = blacks && row[pix] == kernel::black;
+    }
+
+    codes[iter] = whites   ? kernel::kind_whites
+                  : blacks ? kernel::kind_blacks
+                           : kernel::kind_mixed;
+  }
+}
+
+void fill_scalar(unsigned char* dst, size_t count, unsigned char value)
+{
+  std::memset(dst, value, count);
+}
+
+#ifdef BARCH_CODEC_X86_DISPATCH
+
+/// @brief Keeps the lowest bit of every all-ones nibble of the byte mask
+inline uint64_t full_groups(const uint64_t& mask)
+{
+  return mask & (mask >> 1U) & (mask >> 2U) & (mask >> 3U) &
+         0x1111111111111111ULL;
+}
+
+/// @brief Turns the per-byte white and black masks into the group codes
+inline void emit_codes(const uint64_t& whites, const uint64_t& blacks,
+                       const size_t& groups, unsigned char* codes)
+{
+  const uint64_t wfull = full_groups(whites);
+  const uint64_t bfull = full_groups(blacks);
+
+  for (size_t iter = 0U; iter < groups; ++iter) {
+    const unsigned int shift = static_cast<unsigned int>(iter * group);
+    const unsigned int wbit = static_cast<unsigned int>((wfull >> shift) & 1U);
+    const unsigned int bbit = static_cast<unsigned int>((bfull >> shift) & 1U);
+
+    // whites 0, blacks 2, mixed 3
+    codes[iter] = static_cast<unsigned char>(3U - 3U * wbit - bbit);
+  }
+}
+
+// SSE2 is all the 16 byte compares and the byte masks need
+__attribute__((target("sse2"))) void classify_sse2(const unsigned char* row,
+                                                   size_t groups,
+                                                   unsigned char* codes)
+{
+  constexpr const size_t step = sizeof(__m128i) / group;
+
+  const __m128i white = _mm_set1_epi8(static_cast<char>(kernel::white));
+  const __m128i black = _mm_setzero_si128();
+
+  size_t iter = 0U;
+
+  for (; iter + step <= groups; iter += step) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + iter * group));
+
+    const auto wmask = static_cast<uint64_t>(
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, white))));
+    const auto bmask = static_cast<uint64_t>(
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, black))));
+
+    emit_codes(wmask, bmask, step, codes + iter);
+  }
+
+  classify_scalar(row + iter * group, groups - iter, codes + iter);
+}
+
+__attribute__((target("sse2"))) void fill_sse2(unsigned char* dst,
+                                               size_t count,
+                                               unsigned char value)
+{
+  const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+  size_t iter = 0U;
+
+  for (; iter + sizeof(__m128i) <= count; iter += sizeof(__m128i)) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + iter), v);
+  }
+
+  std::memset(dst + iter, value, count - iter);
+}
+
+__attribute__((target("avx2"))) void classify_avx2(const unsigned char* row,
+                                                   size_t groups,
+                                                   unsigned char* codes)
+{
+  constexpr const size_t step = sizeof(__m256i) / group;
+
+  const __m256i white = _mm256_set1_epi8(static_cast<char>(kernel::white));
+  const __m256i black = _mm256_setzero_si256();
+
+  size_t iter = 0U;
+
+  for (; iter + step <= groups; iter += step) {
+    const __m256i v = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(row + iter * group));
+
+    const auto wmask = static_cast<uint64_t>(static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, white))));
+    const auto bmask = static_cast<uint64_t>(static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, black))));
+
+    emit_codes(wmask, bmask, step, codes + iter);
+  }
+
+  classify_scalar(row + iter * group, groups - iter, codes + iter);
+}
+
+__attribute__((target("avx2"))) void fill_avx2(unsigned char* dst,
+                                               size_t count,
+                                               unsigned char value)
+{
+  const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+  size_t iter = 0U;
+
+  for (; iter + sizeof(__m256i) <= count; iter += sizeof(__m256i)) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + iter), v);
+  }
+
+  std::memset(dst + iter, value, count - iter);
+}
+
+__attribute__((target("avx512f,avx512bw"))) void classify_avx512(
+    const unsigned char* row, size_t groups, unsigned char* codes)
+{
+  constexpr const size_t step = sizeof(__m512i) / group;
+
+  const __m512i white = _mm512_set1_epi8(static_cast<char>(kernel::white));
+  const __m512i black = _mm512_setzero_si512();
+
+  size_t iter = 0U;
+
+  for (; iter + step <= groups; iter += step) {
+    const __m512i v = _mm512_loadu_si512(row + iter * group);
+
+    emit_codes(_mm512_cmpeq_epi8_mask(v, white),
+               _mm512_cmpeq_epi8_mask(v, black), step, codes + iter);
+  }
+
+  classify_scalar(row + iter * group, groups - iter, codes + iter);
+}
+
+__attribute__((target("avx512f,avx512bw"))) void fill_avx512(
+    unsigned char* dst, size_t count, unsigned char value)
+{
+  const __m512i v = _mm512_set1_epi8(static_cast<char>(value));
+  size_t iter = 0U;
+
+  for (; iter + sizeof(__m512i) <= count; iter += sizeof(__m512i)) {
+    _mm512_storeu_si512(dst + iter, v);
+  }
+
+  std::memset(dst + iter, value, count - iter);
+}
+
+#endif  // BARCH_CODEC_X86_DISPATCH
+
+constexpr const CodecDispatch scalar_table{classify_scalar, fill_scalar,
+                                           CodecIsa::scalar};
+
+#ifdef BARCH_CODEC_X86_DISPATCH
+constexpr const CodecDispatch sse2_table{classify_sse2, fill_sse2,
+                                         CodecIsa::sse2};
+constexpr const CodecDispatch avx2_table{classify_avx2, fill_avx2,
+                                         CodecIsa::avx2};
+constexpr const CodecDispatch avx512_table{classify_avx512, fill_avx512,
+                                           CodecIsa::avx512};
+#endif  // BARCH_CODEC_X86_DISPATCH
+
+// Resolved at the library load, not on the first conversion
+[[maybe_unused]] const CodecDispatch& load_time_dispatch = codec_dispatch();
+
+}  // namespace
+
+const CodecDispatch& codec_dispatch()
+{
+  static const CodecDispatch table = supported_codec_dispatches().back();
+
+  return table;
+}
+
+std::vector<CodecDispatch> supported_codec_dispatches()
+{
+  std::vector<CodecDispatch> tables{scalar_table};
+
+#ifdef BARCH_CODEC_X86_DISPATCH
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("sse2")) {
+    tables.push_back(sse2_table);
+  }
+
+  if (__builtin_cpu_supports("avx2")) {
+    tables.push_back(avx2_table);
+  }
+
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    tables.push_back(avx512_table);
+  }
+#endif  // BARCH_CODEC_X86_DISPATCH
+
+  return tables;
+}
+
+}  // namespace barchclib0::converters
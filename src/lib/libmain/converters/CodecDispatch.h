@@ -0,0 +1,51 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECDISPATCH_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECDISPATCH_CLASS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace barchclib0::converters
+{
+
+/// @brief The instruction set levels of the codec routines
+enum class CodecIsa
+{
+  scalar = 0,
+  sse2,
+  avx2,
+  avx512
+};
+
+/**
+ * @brief The table of the codec row routines for the 4 pixel groups of the
+ * 8 bit pixels. The vector variants are compiled with the per-function
+ * target attributes, so the single library build carries all of them and
+ * the best one for the running CPU is picked once.
+ */
+struct CodecDispatch
+{
+  /**
+   * @brief Writes the code of every whole group of the row: 0 for all
+   * whites, 2 for all blacks, 3 for the mixed group.
+   */
+  void (*classify_groups)(const unsigned char* row, size_t groups,
+                          unsigned char* codes);
+
+  /// @brief Fills the run of the same pixels
+  void (*fill_pixels)(unsigned char* dst, size_t count, unsigned char value);
+
+  CodecIsa isa;
+};
+
+/**
+ * @brief The table for the best instruction set of the running CPU. Resolved
+ * on the first call, the library load calls it once.
+ */
+const CodecDispatch& codec_dispatch();
+
+/// @brief The tables of all the instruction sets the running CPU supports
+std::vector<CodecDispatch> supported_codec_dispatches();
+
+}  // namespace barchclib0::converters
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECDISPATCH_CLASS_H
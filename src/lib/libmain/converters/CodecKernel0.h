@@ -0,0 +1,851 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECKERNEL0_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECKERNEL0_CLASS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "IBarchImage.h"
+#include "src/lib/libmain/converters/CodecDispatch.h"
+#include "src/lib/libmain/converters/PixelHuffman0.h"
+
+namespace barchclib0::converters
+{
+
+/**
+ * @brief The barch v.0 row codec core, specialized at compile time on the
+ * pixels group size and the pixel bit depth. The converters and the barch
+ * reader delegate their per-pixel loops here: with the constants known to
+ * the compiler the group logic unrolls and inlines, no virtual getters are
+ * called in the loops.
+ *
+ * The group classification and the run fill of the 4 pixel groups of the
+ * 8 bit pixels go through the runtime dispatched vector routines.
+ *
+ * The row bit stream is MSB first and byte aligned at the row end. Every
+ * group of pixels is coded as 0 (all whites), 10 (all blacks) or 11
+ * followed by the raw pixels. The short tail group is always coded as is
+ * and padded with zeros up to the whole group size.
+ *
+ * The long runs variant (BA001) codes the mixed group as 110 and adds the
+ * 111 run code: the color bit (0 whites, 1 blacks) and the Exp-Golomb coded
+ * count of the uniform groups over the shortest run. The encoder takes the
+ * run code wherever it is shorter than the plain group codes.
+ *
+ * With the PixelHuffman0 table given (BA005) the pixels of the as-is
+ * groups are coded with the table codes instead of the raw bits and the
+ * short tail group is only byte aligned, not padded.
+ */
+template <unsigned int batch, unsigned int bits, unsigned int minopt = 2U,
+          bool longruns = false>
+class CodecKernel0
+{
+ public:
+  static_assert(batch > 0U && batch * bits <= 32U,
+                "The raw group has to fit the 32 bit word");
+  static_assert(bits == 8U, "Only the 8 bit grayscale pixels are supported");
+
+  using pixel = unsigned char;
+
+  static constexpr const unsigned int batch_pixels = batch;
+  static constexpr const unsigned int bits_per_pixel = bits;
+  static constexpr const unsigned int min_opt_2_compress = minopt;
+
+  static constexpr const pixel white = static_cast<pixel>((1U << bits) - 1U);
+  static constexpr const pixel black = 0U;
+
+  // The group kinds the classification gives
+  static constexpr const unsigned char kind_whites = 0U;
+  static constexpr const unsigned char kind_blacks = 2U;
+  static constexpr const unsigned char kind_mixed = 3U;
+
+  static constexpr const bool long_runs = longruns;
+
+  static constexpr const unsigned char coded_whites = 0B0;
+  static constexpr const unsigned char coded_whites_bits = 1U;
+  static constexpr const unsigned char coded_blacks = 0B10;
+  static constexpr const unsigned char coded_blacks_bits = 2U;
+  static constexpr const unsigned char coded_as_is = longruns ? 0B110 : 0B11;
+  static constexpr const unsigned char coded_as_is_bits = longruns ? 3U : 2U;
+  static constexpr const unsigned char coded_run = 0B111;
+  static constexpr const unsigned char coded_run_bits = 3U;
+
+  /// @brief The shortest run of the uniform groups the run code covers
+  static constexpr const size_t min_run_groups = 4U;
+
+  static constexpr const unsigned int group_bits = batch * bits;
+
+  /**
+   * @brief Tells whether the row has enough of the whole white or black
+   * groups to be worth the compression. The gray pixels break no run.
+   */
+  static bool optimal_to_compress(const pixel* row, const size_t& width)
+  {
+    unsigned int whites = 0U;
+    unsigned int blacks = 0U;
+    unsigned int groups = 0U;
+
+    for (size_t col = 0U; col < width; ++col) {
+      const pixel value = row[col];
+
+      if (value == white) {
+        blacks = 0U;
+
+        if (++whites == batch) {
+          whites = 0U;
+          ++groups;
+        }
+      } else if (value == black) {
+        whites = 0U;
+
+        if (++blacks == batch) {
+          blacks = 0U;
+          ++groups;
+        }
+      }
+
+      if (groups >= minopt) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /// @brief The codes count of the whole groups of the row
+  static constexpr size_t groups_count(const size_t& width)
+  {
+    return width / batch;
+  }
+
+  /// @brief Writes the kind of every whole group of the row into the codes
+  static void classify_row(const pixel* row, const size_t& width,
+                           unsigned char* codes)
+  {
+    classify_groups(row, groups_count(width), codes);
+  }
+
+  /**
+   * @brief The exact encoded size in bytes of the row with the given group
+   * codes, the tail group padding included.
+   */
+  static size_t encoded_size(const unsigned char* codes, const size_t& width)
+  {
+    size_t total = 0U;
+
+    plan_groups(codes, groups_count(width),
+                [&total](const unsigned char& kind, const size_t& count) {
+                  total += count * group_cost(kind);
+                },
+                [&total](const unsigned char&, const size_t& count) {
+                  total += run_cost(count);
+                });
+
+    const size_t groups = groups_count(width);
+
+    const size_t rest = width - groups * batch;
+
+    if (rest > 0U) {
+      size_t packed = rest * bits;
+
+      total += coded_as_is_bits + packed;
+
+      const size_t padding = (8U - total % 8U) % 8U;
+
+      total += padding;
+      packed += padding;
+
+      for (; packed < group_bits; packed += 8U) {
+        total += 8U;
+      }
+    }
+
+    return (total + 7U) / 8U;
+  }
+
+  /**
+   * @brief The exact encoded size in bytes of the row with the given group
+   * codes and the as-is pixels coded with the table.
+   */
+  static size_t encoded_size(const pixel* row, const unsigned char* codes,
+                             const size_t& width, const PixelHuffman0& table)
+  {
+    size_t total = 0U;
+    const pixel* group = row;
+
+    plan_groups(codes, groups_count(width),
+                [&](const unsigned char& kind, const size_t& count) {
+                  if (kind == kind_mixed) {
+                    total += count * coded_as_is_bits +
+                             table.bits(group, count * batch);
+                  } else {
+                    total += count * group_cost(kind);
+                  }
+
+                  group += count * batch;
+                },
+                [&](const unsigned char&, const size_t& count) {
+                  total += run_cost(count);
+                  group += count * batch;
+                });
+
+    const size_t rest = static_cast<size_t>(row + width - group);
+
+    if (rest > 0U) {
+      total += coded_as_is_bits + table.bits(group, rest);
+    }
+
+    return (total + 7U) / 8U;
+  }
+
+  /// @brief Encodes the row pixels into the cleared buffer
+  static void encode_row(const pixel* row, const size_t& width,
+                         barchdata& comp)
+  {
+    if constexpr (longruns) {
+      // The runs cross the chunk borders, so the whole row codes are needed
+      barchdata rowcodes(groups_count(width));
+
+      classify_row(row, width, rowcodes.data());
+      encode_row(row, width, rowcodes.data(), comp);
+
+      return;
+    }
+
+    comp.clear();
+
+    BitWriter out{comp};
+    const pixel* group = row;
+    const size_t groups = groups_count(width);
+    unsigned char codes[codes_chunk];
+
+    for (size_t done = 0U; done < groups;) {
+      const size_t chunk = std::min(codes_chunk, groups - done);
+
+      classify_groups(group, chunk, codes);
+      emit_groups(out, group, codes, chunk);
+
+      done += chunk;
+    }
+
+    emit_tail(out, group, row + width);
+  }
+
+  /**
+   * @brief Encodes the row pixels with the group codes of the classify_row.
+   * The as-is pixels are coded with the table, if any.
+   */
+  static void encode_row(const pixel* row, const size_t& width,
+                         const unsigned char* codes, barchdata& comp,
+                         const PixelHuffman0* table = nullptr)
+  {
+    comp.clear();
+
+    BitWriter out{comp};
+    const pixel* group = row;
+
+    emit_groups(out, group, codes, groups_count(width), table);
+    emit_tail(out, group, row + width, table);
+  }
+
+  /**
+   * @brief Decodes up to the width pixels of the row into the dst. Returns
+   * the decoded pixels count, less than the width for the truncated data.
+   * The as-is pixels are decoded with the table, if any.
+   */
+  static size_t decode_row(const unsigned char* src, const size_t& size,
+                           pixel* dst, const size_t& width,
+                           const PixelHuffman0* table = nullptr)
+  {
+    BitReader in{src, size};
+    size_t decoded = 0U;
+    uint32_t code = 0U;
+
+    // The neighbour uniform groups are filled as the single run
+    size_t run = 0U;
+    pixel runvalue = white;
+
+    const auto flush = [&]() {
+      if (run == 0U) {
+        return;
+      }
+
+      fill(dst + decoded - run, run, runvalue);
+      run = 0U;
+    };
+
+    const auto extend = [&](const pixel& value, const size_t& count) {
+      if (run > 0U && runvalue != value) {
+        flush();
+      }
+
+      runvalue = value;
+      run += count;
+      decoded += count;
+    };
+
+    while (decoded < width && in.get(1U, code)) {
+      const size_t count = std::min<size_t>(batch, width - decoded);
+
+      if (code == coded_whites) {
+        extend(white, count);
+        continue;
+      }
+
+      if (!in.get(1U, code)) {
+        break;
+      }
+
+      if (code == 0U) {
+        extend(black, count);
+        continue;
+      }
+
+      if constexpr (longruns) {
+        if (!in.get(1U, code)) {
+          break;
+        }
+
+        if (code != 0U) {
+          uint32_t color = 0U;
+          size_t groups = 0U;
+
+          if (!in.get(1U, color) || !in.get_exp_golomb(groups)) {
+            break;
+          }
+
+          extend(color == 0U ? white : black,
+                 std::min((groups + min_run_groups) * batch, width - decoded));
+          continue;
+        }
+      }
+
+      flush();
+
+      if (table != nullptr) {
+        for (size_t iter = 0U; iter < count; ++iter) {
+          const uint16_t entry =
+              table->lookup(in.peek(PixelHuffman0::max_code_bits));
+
+          if ((entry >> 8U) == 0U || !in.skip(entry >> 8U)) {
+            return decoded;
+          }
+
+          dst[decoded++] = static_cast<pixel>(entry & 0xFFU);
+        }
+
+        continue;
+      }
+
+      for (size_t iter = 0U; iter < count; ++iter) {
+        if (!in.get(bits, code)) {
+          return decoded;
+        }
+
+        dst[decoded++] = static_cast<pixel>(code);
+      }
+    }
+
+    flush();
+
+    return decoded;
+  }
+
+  /**
+   * @brief Decodes every step-th pixel of the [first, end) columns of the
+   * row into the dst: the uniform groups and runs are filled straight into
+   * their output pixels, the as-is pixels are parsed and the sampled ones
+   * kept. The parsing stops at the end column. Returns the output pixels
+   * count, less than the sampled columns count for the truncated data.
+   */
+  static size_t decode_row_sampled(const unsigned char* src,
+                                   const size_t& size, pixel* dst,
+                                   const size_t& first, const size_t& end,
+                                   const size_t& step,
+                                   const PixelHuffman0* table = nullptr)
+  {
+    BitReader in{src, size};
+    size_t decoded = 0U;
+    size_t out = 0U;
+    uint32_t code = 0U;
+
+    // The uniform span of the row maps to the output pixels up to its end
+    const auto span = [&](const pixel& value, const size_t& count) {
+      decoded += count;
+
+      const size_t upto =
+          decoded <= first ? 0U : (decoded - first + step - 1U) / step;
+
+      if (upto > out) {
+        fill(dst + out, upto - out, value);
+        out = upto;
+      }
+    };
+
+    const auto put = [&](const uint32_t& value) {
+      if (decoded >= first && (decoded - first) % step == 0U) {
+        dst[out++] = static_cast<pixel>(value);
+      }
+
+      ++decoded;
+    };
+
+    while (decoded < end && in.get(1U, code)) {
+      const size_t count = std::min<size_t>(batch, end - decoded);
+
+      if (code == coded_whites) {
+        span(white, count);
+        continue;
+      }
+
+      if (!in.get(1U, code)) {
+        break;
+      }
+
+      if (code == 0U) {
+        span(black, count);
+        continue;
+      }
+
+      if constexpr (longruns) {
+        if (!in.get(1U, code)) {
+          break;
+        }
+
+        if (code != 0U) {
+          uint32_t color = 0U;
+          size_t groups = 0U;
+
+          if (!in.get(1U, color) || !in.get_exp_golomb(groups)) {
+            break;
+          }
+
+          span(color == 0U ? white : black,
+               std::min((groups + min_run_groups) * batch, end - decoded));
+          continue;
+        }
+      }
+
+      for (size_t iter = 0U; iter < count; ++iter) {
+        if (table != nullptr) {
+          const uint16_t entry =
+              table->lookup(in.peek(PixelHuffman0::max_code_bits));
+
+          if ((entry >> 8U) == 0U || !in.skip(entry >> 8U)) {
+            return out;
+          }
+
+          put(entry & 0xFFU);
+        } else if (in.get(bits, code)) {
+          put(code);
+        } else {
+          return out;
+        }
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief The bytes count of the encoded row of the given width at the
+   * start of the data, capped by the data size.
+   */
+  static size_t encoded_row_size(const unsigned char* src, const size_t& size,
+                                 const size_t& width,
+                                 const PixelHuffman0* table = nullptr)
+  {
+    BitReader in{src, size};
+    size_t counted = 0U;
+    uint32_t code = 0U;
+
+    while (counted < width && in.get(1U, code)) {
+      size_t groups = 1U;
+
+      if (code != coded_whites) {
+        if (!in.get(1U, code)) {
+          break;
+        }
+
+        if constexpr (longruns) {
+          if (code != 0U) {
+            if (!in.get(1U, code)) {
+              break;
+            }
+
+            if (code != 0U) {
+              if (!in.skip(1U) || !in.get_exp_golomb(groups)) {
+                return size;
+              }
+
+              groups += min_run_groups;
+              code = 0U;
+            } else {
+              code = 1U;
+            }
+          }
+        }
+
+        if (code != 0U && table != nullptr) {
+          const size_t count = std::min<size_t>(batch, width - counted);
+
+          for (size_t iter = 0U; iter < count; ++iter) {
+            const uint16_t entry =
+                table->lookup(in.peek(PixelHuffman0::max_code_bits));
+
+            if ((entry >> 8U) == 0U || !in.skip(entry >> 8U)) {
+              return size;
+            }
+          }
+        } else if (code != 0U && !in.skip(group_bits)) {
+          return size;
+        }
+      }
+
+      counted += groups * batch;
+    }
+
+    return std::min(size, in.consumed_bytes());
+  }
+
+ private:
+  /// @brief The group codes computed per a single classification call
+  static constexpr const size_t codes_chunk = 256U;
+
+  static constexpr const bool dispatched = batch == 4U && bits == 8U;
+
+  /// @brief The MSB first bits appender over the row buffer
+  struct BitWriter
+  {
+    barchdata& dst;
+    uint64_t acc{0U};
+    unsigned int count{0U};
+
+    void put(const uint32_t& value, const unsigned int& nbits)
+    {
+      acc = (acc << nbits) | value;
+      count += nbits;
+
+      while (count >= 8U) {
+        count -= 8U;
+        dst.push_back(static_cast<unsigned char>(acc >> count));
+      }
+
+      acc &= (uint64_t{1} << count) - 1U;
+    }
+
+    /// @brief The order 0 Exp-Golomb code of the value
+    void put_exp_golomb(const size_t& value)
+    {
+      const uint64_t coded = static_cast<uint64_t>(value) + 1U;
+      const unsigned int width = bit_width(coded);
+
+      put(0U, width - 1U);
+
+      for (unsigned int left = width; left > 0U;) {
+        const unsigned int take = std::min(left, 16U);
+
+        left -= take;
+        put(static_cast<uint32_t>((coded >> left) & ((1U << take) - 1U)),
+            take);
+      }
+    }
+
+    /// @brief Pads the last byte with zeros. Returns the padding bits count.
+    unsigned int align()
+    {
+      if (count == 0U) {
+        return 0U;
+      }
+
+      const unsigned int padding = 8U - count;
+
+      put(0U, padding);
+
+      return padding;
+    }
+  };
+
+  /// @brief The MSB first bits reader over the row data
+  struct BitReader
+  {
+    const unsigned char* src;
+    size_t size;
+    size_t pos{0U};
+
+    bool get(const unsigned int& nbits, uint32_t& value)
+    {
+      if (pos + nbits > size * 8U) {
+        return false;
+      }
+
+      value = 0U;
+
+      for (unsigned int left = nbits; left > 0U;) {
+        const unsigned int offset = static_cast<unsigned int>(pos % 8U);
+        const unsigned int take = std::min(left, 8U - offset);
+        const unsigned int chunk =
+            (static_cast<unsigned int>(src[pos / 8U]) >> (8U - offset - take)) &
+            ((1U << take) - 1U);
+
+        value = (value << take) | chunk;
+        pos += take;
+        left -= take;
+      }
+
+      return true;
+    }
+
+    bool get_exp_golomb(size_t& value)
+    {
+      unsigned int zeros = 0U;
+      uint32_t bit = 0U;
+
+      for (;;) {
+        if (!get(1U, bit)) {
+          return false;
+        }
+
+        if (bit != 0U) {
+          break;
+        }
+
+        if (++zeros > max_exp_golomb_zeros) {
+          return false;
+        }
+      }
+
+      uint64_t coded = 1U;
+
+      for (unsigned int left = zeros; left > 0U;) {
+        const unsigned int take = std::min(left, 16U);
+        uint32_t chunk = 0U;
+
+        if (!get(take, chunk)) {
+          return false;
+        }
+
+        coded = (coded << take) | chunk;
+        left -= take;
+      }
+
+      value = coded - 1U;
+
+      return true;
+    }
+
+    bool skip(const unsigned int& nbits)
+    {
+      if (pos + nbits > size * 8U) {
+        return false;
+      }
+
+      pos += nbits;
+
+      return true;
+    }
+
+    /**
+     * @brief The next nbits, up to 24, without the consumption. The bits
+     * past the data end read as zeros.
+     */
+    uint32_t peek(const unsigned int& nbits) const
+    {
+      const size_t byte = pos / 8U;
+      uint32_t window = 0U;
+
+      for (size_t iter = 0U; iter < sizeof(uint32_t); ++iter) {
+        window = (window << 8U) |
+                 (byte + iter < size ? src[byte + iter] : uint32_t{0U});
+      }
+
+      return (window << (pos % 8U)) >> (32U - nbits);
+    }
+
+    size_t consumed_bytes() const { return (pos + 7U) / 8U; }
+  };
+
+  /// @brief The longest run count the reader accepts, in the prefix zeros
+  static constexpr const unsigned int max_exp_golomb_zeros = 40U;
+
+  static constexpr unsigned int bit_width(uint64_t value)
+  {
+    unsigned int width = 0U;
+
+    for (; value != 0U; value >>= 1U) {
+      ++width;
+    }
+
+    return width;
+  }
+
+  /// @brief The bits of the single group code of the kind
+  static constexpr size_t group_cost(const unsigned char& kind)
+  {
+    if (kind == kind_whites) {
+      return coded_whites_bits;
+    }
+
+    if (kind == kind_blacks) {
+      return coded_blacks_bits;
+    }
+
+    return coded_as_is_bits + group_bits;
+  }
+
+  /// @brief The bits of the run code over the given groups count
+  static constexpr size_t run_cost(const size_t& groups)
+  {
+    return coded_run_bits + 1U +
+           2U * bit_width(groups - min_run_groups + 1U) - 1U;
+  }
+
+  /**
+   * @brief Walks the group kinds calling the single(kind, count) for the
+   * plain coded groups and the run(kind, count) for the run coded spans
+   */
+  template <typename Single, typename Run>
+  static void plan_groups(const unsigned char* codes, const size_t& count,
+                          Single&& single, Run&& run)
+  {
+    for (size_t iter = 0U; iter < count;) {
+      const unsigned char kind = codes[iter];
+      size_t span = 1U;
+
+      if constexpr (longruns) {
+        if (kind != kind_mixed) {
+          while (iter + span < count && codes[iter + span] == kind) {
+            ++span;
+          }
+
+          if (span >= min_run_groups &&
+              run_cost(span) < span * group_cost(kind)) {
+            run(kind, span);
+            iter += span;
+            continue;
+          }
+        }
+      }
+
+      single(kind, span);
+      iter += span;
+    }
+  }
+
+  static void emit_groups(BitWriter& out, const pixel*& group,
+                          const unsigned char* codes, const size_t& count,
+                          const PixelHuffman0* table = nullptr)
+  {
+    plan_groups(
+        codes, count,
+        [&out, &group, table](const unsigned char& kind, const size_t& span) {
+          for (size_t iter = 0U; iter < span; ++iter, group += batch) {
+            if (kind == kind_whites) {
+              out.put(coded_whites, coded_whites_bits);
+            } else if (kind == kind_blacks) {
+              out.put(coded_blacks, coded_blacks_bits);
+            } else if (table != nullptr) {
+              out.put(coded_as_is, coded_as_is_bits);
+              put_coded(out, group, batch, *table);
+            } else {
+              out.put(coded_as_is, coded_as_is_bits);
+              out.put(raw_group(group, batch), group_bits);
+            }
+          }
+        },
+        [&out, &group](const unsigned char& kind, const size_t& span) {
+          out.put(coded_run, coded_run_bits);
+          out.put(kind == kind_whites ? 0U : 1U, 1U);
+          out.put_exp_golomb(span - min_run_groups);
+          group += span * batch;
+        });
+  }
+
+  /// @brief Puts the table codes of the pixels
+  static void put_coded(BitWriter& out, const pixel* pixels,
+                        const size_t& count, const PixelHuffman0& table)
+  {
+    for (size_t iter = 0U; iter < count; ++iter) {
+      out.put(table.code(pixels[iter]), table.length(pixels[iter]));
+    }
+  }
+
+  /// @brief Codes the short tail group as is and aligns the row end
+  static void emit_tail(BitWriter& out, const pixel* group, const pixel* end,
+                        const PixelHuffman0* table = nullptr)
+  {
+    if (group < end && table != nullptr) {
+      out.put(coded_as_is, coded_as_is_bits);
+      put_coded(out, group, static_cast<size_t>(end - group), *table);
+    } else if (group < end) {
+      const unsigned int rest = static_cast<unsigned int>(end - group);
+      unsigned int packed = rest * bits;
+
+      out.put(coded_as_is, coded_as_is_bits);
+      out.put(raw_group(group, rest), packed);
+
+      packed += out.align();
+
+      for (; packed < group_bits; packed += 8U) {
+        out.dst.push_back(0U);
+      }
+    }
+
+    out.align();
+  }
+
+  static void classify_groups(const pixel* row, const size_t& groups,
+                              unsigned char* codes)
+  {
+    if constexpr (dispatched) {
+      codec_dispatch().classify_groups(row, groups, codes);
+    } else {
+      for (size_t iter = 0U; iter < groups; ++iter, row += batch) {
+        codes[iter] = classify(row);
+      }
+    }
+  }
+
+  static unsigned char classify(const pixel* group)
+  {
+    bool whites = true;
+    bool blacks = true;
+
+    for (unsigned int iter = 0U; iter < batch; ++iter) {
+      whites = whites && group[iter] == white;
+      blacks = blacks && group[iter] == black;
+    }
+
+    if (whites) {
+      return kind_whites;
+    }
+
+    return blacks ? kind_blacks : kind_mixed;
+  }
+
+  static uint32_t raw_group(const pixel* group, const unsigned int& count)
+  {
+    uint32_t word = 0U;
+
+    for (unsigned int iter = 0U; iter < count; ++iter) {
+      word = (word << bits) | group[iter];
+    }
+
+    return word;
+  }
+
+  static void fill(pixel* dst, const size_t& count, const pixel& value)
+  {
+    if constexpr (dispatched) {
+      codec_dispatch().fill_pixels(dst, count, value);
+    } else {
+      for (size_t iter = 0U; iter < count; ++iter) {
+        dst[iter] = value;
+      }
+    }
+  }
+};
+
+}  // namespace barchclib0::converters
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_CODECKERNEL0_CLASS_H
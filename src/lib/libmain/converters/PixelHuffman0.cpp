@@ -0,0 +1,144 @@
+#include "src/lib/libmain/converters/PixelHuffman0.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace barchclib0::converters
+{
+
+namespace
+{
+
+/// @brief The plain Huffman code lengths of the counts, all non zero
+void huffman_lengths(const PixelHuffman0::counts& weights,
+                     PixelHuffman0::lengthstable& lengths)
+{
+  using node = std::pair<uint64_t, size_t>;
+
+  constexpr const size_t symbols = PixelHuffman0::symbols;
+
+  // The leaves go first, the merged nodes after them
+  std::vector<size_t> parent(symbols * 2U, 0U);
+  std::priority_queue<node, std::vector<node>, std::greater<node>> queue;
+
+  for (size_t iter = 0U; iter < symbols; ++iter) {
+    queue.emplace(weights[iter], iter);
+  }
+
+  size_t next = symbols;
+
+  while (queue.size() > 1U) {
+    const node first = queue.top();
+    queue.pop();
+    const node second = queue.top();
+    queue.pop();
+
+    parent[first.second] = next;
+    parent[second.second] = next;
+    queue.emplace(first.first + second.first, next++);
+  }
+
+  const size_t root = next - 1U;
+
+  for (size_t iter = 0U; iter < symbols; ++iter) {
+    unsigned int depth = 0U;
+
+    for (size_t at = iter; at != root; at = parent[at]) {
+      ++depth;
+    }
+
+    lengths[iter] = static_cast<unsigned char>(depth);
+  }
+}
+
+}  // namespace
+
+PixelHuffman0 PixelHuffman0::build(const counts& ncounts)
+{
+  counts weights;
+
+  // Every value gets the code
+  for (size_t iter = 0U; iter < symbols; ++iter) {
+    weights[iter] = ncounts[iter] + 1U;
+  }
+
+  lengthstable lengths{};
+
+  for (;;) {
+    huffman_lengths(weights, lengths);
+
+    if (*std::max_element(lengths.cbegin(), lengths.cend()) <= max_code_bits) {
+      break;
+    }
+
+    // Flattens the distribution until the longest code fits the lookup
+    for (auto& weight : weights) {
+      weight = (weight + 1U) / 2U;
+    }
+  }
+
+  PixelHuffman0 huffman;
+
+  huffman.assign(lengths.data(), lengths.size());
+
+  return huffman;
+}
+
+bool PixelHuffman0::assign(const unsigned char* nlengths, const size_t& count)
+{
+  if (nlengths == nullptr || count != symbols) {
+    return false;
+  }
+
+  // The Kraft sum in the units of the longest code
+  uint32_t kraft = 0U;
+
+  for (size_t iter = 0U; iter < symbols; ++iter) {
+    if (nlengths[iter] > max_code_bits) {
+      return false;
+    }
+
+    if (nlengths[iter] > 0U) {
+      kraft += 1U << (max_code_bits - nlengths[iter]);
+    }
+  }
+
+  if (kraft > (1U << max_code_bits)) {
+    return false;
+  }
+
+  std::copy_n(nlengths, symbols, mlengths.begin());
+  mcodes.fill(0U);
+  mtable.assign(size_t{1} << max_code_bits, 0U);
+
+  uint32_t code = 0U;
+
+  for (unsigned int length = 1U; length <= max_code_bits; ++length) {
+    for (unsigned int value = 0U; value < symbols; ++value) {
+      if (mlengths[value] != length) {
+        continue;
+      }
+
+      mcodes[value] = code;
+
+      const uint32_t first = code << (max_code_bits - length);
+      const uint32_t span = 1U << (max_code_bits - length);
+
+      std::fill_n(mtable.begin() + first, span,
+                  static_cast<uint16_t>((length << 8U) | value));
+
+      ++code;
+    }
+
+    code <<= 1U;
+  }
+
+  return true;
+}
+
+}  // namespace barchclib0::converters
@@ -0,0 +1,77 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_PIXELHUFFMAN0_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_PIXELHUFFMAN0_CLASS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace barchclib0::converters
+{
+
+/**
+ * @brief The per-image canonical Huffman code of the 8 bit pixels of the
+ * as-is groups. Only the code lengths are stored in the file, the codes are
+ * restored canonically: ordered by the length, then by the pixel value.
+ *
+ * The lengths are limited to the max_code_bits, so the decoder resolves
+ * every code with the single lookup of the next max_code_bits bits.
+ */
+class PixelHuffman0
+{
+ public:
+  static constexpr const unsigned int symbols = 256U;
+  static constexpr const unsigned int max_code_bits = 12U;
+
+  using counts = std::array<uint64_t, symbols>;
+  using lengthstable = std::array<unsigned char, symbols>;
+
+  /**
+   * @brief Builds the code for the pixel counts. Every pixel value gets the
+   * code, the never seen ones the longest, so any row can be coded.
+   */
+  static PixelHuffman0 build(const counts& ncounts);
+
+  /**
+   * @brief Restores the code from the stored lengths. Returns false for the
+   * lengths no prefix code has.
+   */
+  bool assign(const unsigned char* nlengths, const size_t& count);
+
+  const lengthstable& lengths() const { return mlengths; }
+
+  unsigned int length(const unsigned char& value) const
+  {
+    return mlengths[value];
+  }
+
+  uint32_t code(const unsigned char& value) const { return mcodes[value]; }
+
+  /**
+   * @brief The entry of the code at the start of the next max_code_bits
+   * bits: the pixel value in the low byte and the code length above it.
+   * Zero length for the bits no code starts with.
+   */
+  uint16_t lookup(const uint32_t& peek) const { return mtable[peek]; }
+
+  /// @brief The total bits of the given pixels codes
+  size_t bits(const unsigned char* pixels, const size_t& count) const
+  {
+    size_t total = 0U;
+
+    for (size_t iter = 0U; iter < count; ++iter) {
+      total += mlengths[pixels[iter]];
+    }
+
+    return total;
+  }
+
+ private:
+  lengthstable mlengths{};
+  std::array<uint32_t, symbols> mcodes{};
+  std::vector<uint16_t> mtable;
+};
+
+}  // namespace barchclib0::converters
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_PIXELHUFFMAN0_CLASS_H
@@ -1,12 +1,17 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "src/lib/libmain/converters/BMP2BarchConverter0.h"
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
 #include "src/lib/libmain/images/BMPImage.h"
 #include "src/lib/libmain/images/BarchImage.h"
 
@@ -1094,3 +1099,347 @@ TEST_F(UTEST_BMP2BarchConverter0,
               << std::endl;
   }
 }
+
+TEST_F(UTEST_BMP2BarchConverter0, row_tasks_convert_matches_sequential_success)
+{
+  static constexpr const size_t width = 32U;
+  static constexpr const size_t height = 16384U;
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(height);
+
+  barchdata data(width * height, white_pixel);
+
+  for (size_t iter = 0U; iter < data.size(); ++iter) {
+    if ((iter / width) % 3U == 1U) {
+      data[iter] = static_cast<unsigned char>(iter % width);
+    }
+  }
+
+  bmp->data(data);
+
+  BarchImagePtr sequential = conv->convert(bmp);
+
+  ASSERT_NE(sequential, nullptr);
+
+  auto scheduler = executor::WorkStealingScheduler::create(2U);
+  BarchImagePtr rows;
+  std::atomic_bool done{false};
+
+  scheduler->spawn([&]() {
+    rows = BMP2BarchConverter0::create()->convert(bmp);
+    done.store(true);
+  });
+
+  // not helping: the conversion must run on a worker to split the rows
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  ASSERT_NE(rows, nullptr);
+  EXPECT_EQ(rows->lines_table(), sequential->lines_table());
+  EXPECT_EQ(rows->data(), sequential->data());
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, exact_size_keeps_growing_row_raw_success)
+{
+  // The 2 runs and 40 gray groups: 1363 encoded bits for 168 raw bytes
+  barchdata row(168U, gray_pixel);
+
+  std::fill_n(row.begin(), 4U, white_pixel);
+  std::fill_n(row.begin() + 4U, 4U, 0U);
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(row.size());
+  bmp->height(1U);
+  bmp->data(row);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_FALSE(barch->lines_table()[0U]);
+  EXPECT_EQ(barch->data(), row);
+
+  conv->decision(BMP2BarchConverter0::CompressDecision::runs_threshold);
+
+  barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_TRUE(barch->lines_table()[0U]);
+  EXPECT_GT(barch->data().size(), row.size());
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, exact_size_compresses_shrinking_row_success)
+{
+  // The single run is under the v.0 threshold, still 1 byte instead of 4
+  barchdata row(4U, white_pixel);
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(row.size());
+  bmp->height(1U);
+  bmp->data(row);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_TRUE(barch->lines_table()[0U]);
+  EXPECT_THAT(barch->data(), ElementsAre(0U));
+
+  conv->decision(BMP2BarchConverter0::CompressDecision::runs_threshold);
+
+  barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_FALSE(barch->lines_table()[0U]);
+  EXPECT_EQ(barch->data(), row);
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, ba001_long_white_rows_convert_success)
+{
+  barchdata data(256U * 3U, white_pixel);
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(256U);
+  bmp->height(3U);
+  bmp->data(data);
+
+  conv->format(BarchFormat::ba001);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_EQ(barch->format(), BarchFormat::ba001);
+  EXPECT_THAT(barch->lines_table(), Each(true));
+  EXPECT_THAT(barch->data(), ElementsAre(0B11100000, 0B01111010, 0B11100000,
+                                         0B01111010, 0B11100000, 0B01111010));
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, ba002_uniform_rows_without_payload_success)
+{
+  static constexpr const size_t width = 9U;
+
+  barchdata data(width * 4U, white_pixel);
+
+  std::fill_n(data.begin() + width, width, 0U);
+  data[width * 2U + 3U] = gray_pixel;
+  data[width * 3U + 3U] = 0U;
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(4U);
+  bmp->data(data);
+
+  conv->format(BarchFormat::ba002);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_EQ(barch->format(), BarchFormat::ba002);
+  EXPECT_THAT(barch->fills_table(),
+              ElementsAre(RowFill::whites, RowFill::blacks, RowFill::none,
+                          RowFill::none));
+  EXPECT_TRUE(barch->lines_table()[0U]);
+  EXPECT_TRUE(barch->lines_table()[1U]);
+  EXPECT_TRUE(barch->scanline(0U).empty());
+  EXPECT_TRUE(barch->scanline(1U).empty());
+  EXPECT_FALSE(barch->scanline(2U).empty());
+  EXPECT_FALSE(barch->scanline(3U).empty());
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, ba003_repeated_rows_references_success)
+{
+  static constexpr const size_t width = 11U;
+  static constexpr const size_t height = 14U;
+
+  barchdata data(width * height, gray_pixel);
+
+  // Row 0 pattern repeats at rows 1 and 3, row 2 differs, row 13 repeats
+  // row 2 from beyond the window
+  for (size_t row = 0U; row < height; ++row) {
+    data[row * width + row % width] = 0U;
+  }
+
+  std::copy_n(data.begin(), width, data.begin() + width);
+  std::copy_n(data.begin(), width, data.begin() + width * 3U);
+  std::copy_n(data.begin() + width * 2U, width, data.begin() + width * 13U);
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(height);
+  bmp->data(data);
+
+  conv->format(BarchFormat::ba003);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_EQ(barch->format(), BarchFormat::ba003);
+  EXPECT_EQ(barch->row_ref(0U), 0U);
+  EXPECT_EQ(barch->row_ref(1U), 1U);
+  EXPECT_EQ(barch->row_ref(2U), 0U);
+  EXPECT_EQ(barch->row_ref(3U), 2U);
+  EXPECT_EQ(barch->row_ref(13U), 0U);
+  EXPECT_TRUE(barch->scanline(1U).empty());
+  EXPECT_TRUE(barch->scanline(3U).empty());
+  EXPECT_FALSE(barch->scanline(13U).empty());
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, ba004_coherent_rows_predicted_success)
+{
+  static constexpr const size_t width = 64U;
+  static constexpr const size_t height = 3U;
+
+  // The gray texture rows differ in the single pixel only
+  barchdata data(width * height, 0U);
+
+  for (size_t col = 0U; col < width; ++col) {
+    data[col] = static_cast<unsigned char>(col * 3U + 1U);
+  }
+
+  std::copy_n(data.begin(), width, data.begin() + width);
+  std::copy_n(data.begin(), width, data.begin() + width * 2U);
+  data[width + 10U] = 0U;
+  data[width * 2U + 20U] = 0U;
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(height);
+  bmp->data(data);
+
+  conv->format(BarchFormat::ba004);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_THAT(barch->predicted_table(), ElementsAre(false, true, true));
+  EXPECT_THAT(barch->lines_table(), ElementsAre(false, true, true));
+  EXPECT_LT(barch->scanline(1U).size(), width / 4U);
+  EXPECT_LT(barch->scanline(2U).size(), width / 4U);
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, quantization_noisy_scan_snapped_success)
+{
+  static constexpr const size_t width = 16U;
+
+  // The scanner noise around the white paper and the black strokes
+  const barchdata row{255U, 254U, 251U, 255U, 3U, 0U, 1U, 5U,
+                      255U, 252U, 255U, 255U, 128U, 2U, 0U, 0U};
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(1U);
+  bmp->data(row);
+
+  auto lossless = conv->convert(bmp);
+
+  ASSERT_NE(lossless, nullptr);
+  EXPECT_EQ(lossless->quantization_error(), 0U);
+  EXPECT_THAT(lossless->lines_table(), ElementsAre(false));
+
+  ASSERT_TRUE(conv->quantization(Quantization{250U, 5U}));
+
+  auto lossy = conv->convert(bmp);
+
+  ASSERT_NE(lossy, nullptr);
+  EXPECT_EQ(lossy->quantization_error(), 5U);
+  EXPECT_THAT(lossy->lines_table(), ElementsAre(true));
+  // whites, blacks, as-is of the 128 and 3 snapped blacks
+  EXPECT_LT(lossy->data().size(), 8U);
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, quantization_overlapping_ranges_failure)
+{
+  EXPECT_FALSE(conv->quantization(Quantization{100U, 100U}));
+  EXPECT_TRUE(conv->quantization().lossless());
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, presets_set_encoder_configuration_success)
+{
+  using decision = BMP2BarchConverter0::CompressDecision;
+
+  conv->preset(EncoderPreset::fast);
+
+  EXPECT_EQ(conv->format(), BarchFormat::ba000);
+  EXPECT_EQ(conv->decision(), decision::runs_threshold);
+
+  conv->preset(EncoderPreset::max_ratio);
+
+  EXPECT_EQ(conv->format(), BarchFormat::ba005);
+  EXPECT_EQ(conv->decision(), decision::exact_size);
+
+  conv->preset(EncoderPreset::balanced);
+
+  EXPECT_EQ(conv->format(), BarchFormat::ba000);
+  EXPECT_EQ(conv->decision(), decision::exact_size);
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, sampled_incompressible_image_raw_rows_success)
+{
+  static constexpr const size_t width = 40U;
+  static constexpr const size_t height = BMP2BarchConverter0::sampled_rows * 2U;
+
+  // The photo-like noise without the white or black groups
+  barchdata data(width * height);
+
+  for (size_t iter = 0U; iter < data.size(); ++iter) {
+    data[iter] = static_cast<unsigned char>(1U + (iter * 2654435761U >> 7U) %
+                                                     253U);
+  }
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(height);
+  bmp->data(data);
+
+  conv->format(BarchFormat::ba004);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_THAT(barch->lines_table(), Each(false));
+  EXPECT_THAT(barch->predicted_table(), Each(false));
+  EXPECT_EQ(barch->data(), data);
+}
+
+TEST_F(UTEST_BMP2BarchConverter0, sampled_saving_threshold_success)
+{
+  static constexpr const size_t width = 40U;
+  static constexpr const size_t height = BMP2BarchConverter0::sampled_rows * 2U;
+
+  // The document: white paper with a short gray mark on every row
+  barchdata data(width * height, white_pixel);
+
+  for (size_t row = 0U; row < height; ++row) {
+    data[row * width + row % width] = 100U;
+  }
+
+  auto bmp = BMPImage::create();
+
+  bmp->width(width);
+  bmp->height(height);
+  bmp->data(data);
+
+  auto barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_THAT(barch->lines_table(), Each(true));
+
+  // No coding saves all the raw size
+  conv->min_sampled_saving(1.0);
+
+  barch = conv->convert(bmp);
+
+  ASSERT_NE(barch, nullptr);
+  EXPECT_THAT(barch->lines_table(), Each(false));
+  EXPECT_EQ(barch->data(), data);
+}
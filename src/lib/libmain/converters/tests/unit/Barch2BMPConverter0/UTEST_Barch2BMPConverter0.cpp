@@ -6,6 +6,7 @@
 #include <string>
 
 #include "src/lib/libmain/converters/Barch2BMPConverter0.h"
+#include "src/lib/libmain/converters/CodecKernel0.h"
 #include "src/lib/libmain/images/BarchImage.h"
 
 using namespace barchclib0;
@@ -992,3 +993,218 @@ TEST_F(UTEST_Barch2BMPConverter0,
         << "Absent pixel in converted data at " << (bmpter++);
   }
 }
+
+TEST_F(UTEST_Barch2BMPConverter0, ba001_825whites_pixels_decode_success)
+{
+  static constexpr const unsigned int cwidth = 825U;
+
+  const barchdata expected(cwidth, white_pixel);
+  barchdata runs;
+
+  CodecKernel0<4U, 8U, 2U, true>::encode_row(expected.data(), cwidth, runs);
+
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(cwidth);
+  barch->format(BarchFormat::ba001);
+  barch->lines_table(linestable(1, true));
+  barch->append_line(runs);
+
+  auto bmp = conv->convert(barch);
+
+  ASSERT_NE(bmp, nullptr);
+  EXPECT_EQ(bmp->data(), expected);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba002_uniform_rows_fill_success)
+{
+  static constexpr const unsigned int cwidth = 13U;
+
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(cwidth);
+  barch->format(BarchFormat::ba002);
+  barch->lines_table(linestable{true, false, true});
+  barch->fills_table(fillstable{RowFill::blacks, RowFill::none,
+                                RowFill::whites});
+  barch->append_line(barchdata{});
+  barch->append_line(barchdata(cwidth, gray_pixel));
+  barch->append_line(barchdata{});
+
+  auto bmp = conv->convert(barch);
+
+  ASSERT_NE(bmp, nullptr);
+
+  barchdata expected(cwidth, zero);
+
+  expected.insert(expected.end(), cwidth, gray_pixel);
+  expected.insert(expected.end(), cwidth, white_pixel);
+
+  EXPECT_EQ(bmp->data(), expected);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba002_no_payload_no_fills_failure)
+{
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(4U);
+  barch->format(BarchFormat::ba002);
+  barch->lines_table(linestable{true});
+  barch->append_line(barchdata{});
+
+  EXPECT_EQ(conv->convert(barch), nullptr);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba003_repeated_rows_copy_success)
+{
+  static constexpr const unsigned int cwidth = 6U;
+
+  barchdata first{1U, 2U, 3U, 4U, 5U, 6U};
+
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(cwidth);
+  barch->format(BarchFormat::ba003);
+  barch->lines_table(linestable{false, true, true, true});
+  barch->fills_table(fillstable{RowFill::none, RowFill::whites,
+                                RowFill::none, RowFill::none});
+  // The row 3 refers the row 2, which refers the row 0
+  barch->refs_table(refstable{0U, 0U, 2U, 1U});
+  barch->append_line(first);
+  barch->append_line(barchdata{});
+  barch->append_line(barchdata{});
+  barch->append_line(barchdata{});
+
+  auto bmp = conv->convert(barch);
+
+  ASSERT_NE(bmp, nullptr);
+
+  barchdata expected = first;
+
+  expected.insert(expected.end(), cwidth, white_pixel);
+  expected.insert(expected.end(), first.begin(), first.end());
+  expected.insert(expected.end(), first.begin(), first.end());
+
+  EXPECT_EQ(bmp->data(), expected);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba003_reference_above_image_failure)
+{
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(4U);
+  barch->format(BarchFormat::ba003);
+  barch->lines_table(linestable{false, true});
+  barch->refs_table(refstable{0U, 2U});
+  barch->append_line(barchdata(4U, gray_pixel));
+  barch->append_line(barchdata{});
+
+  EXPECT_EQ(conv->convert(barch), nullptr);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba004_predicted_rows_restore_success)
+{
+  static constexpr const unsigned int cwidth = 4U;
+
+  const barchdata first{1U, 2U, 3U, 4U};
+  // The residual keeps the equal pixels white: the 2nd pixel becomes 0
+  const barchdata residual{white_pixel, static_cast<unsigned char>(~2U),
+                           white_pixel, white_pixel};
+  barchdata coded;
+
+  CodecKernel0<4U, 8U, 2U, true>::encode_row(residual.data(), cwidth, coded);
+
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(cwidth);
+  barch->format(BarchFormat::ba004);
+  barch->lines_table(linestable{false, true, true});
+  barch->predicted_table(predictedtable{false, true, false});
+  // The reference reads the restored predicted row
+  barch->refs_table(refstable{0U, 0U, 1U});
+  barch->append_line(first);
+  barch->append_line(coded);
+  barch->append_line(barchdata{});
+
+  auto bmp = conv->convert(barch);
+
+  ASSERT_NE(bmp, nullptr);
+  EXPECT_THAT(bmp->data(), ElementsAre(1U, 2U, 3U, 4U, 1U, 0U, 3U, 4U, 1U, 0U,
+                                       3U, 4U));
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, ba004_first_row_predicted_failure)
+{
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(4U);
+  barch->format(BarchFormat::ba004);
+  barch->lines_table(linestable{true});
+  barch->predicted_table(predictedtable{true});
+  barch->append_line(barchdata{0U});
+
+  EXPECT_EQ(conv->convert(barch), nullptr);
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, bottom_up_strided_target_decode_success)
+{
+  static constexpr const unsigned int cwidth = 4U;
+  static constexpr const size_t stride = 6U;
+  static constexpr const unsigned char padding = 0xABU;
+
+  const barchdata first{1U, 2U, 3U, 4U};
+  const barchdata residual{white_pixel, static_cast<unsigned char>(~2U),
+                           white_pixel, white_pixel};
+  barchdata coded;
+
+  CodecKernel0<4U, 8U, 2U, true>::encode_row(residual.data(), cwidth, coded);
+
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(cwidth);
+  barch->format(BarchFormat::ba004);
+  barch->lines_table(linestable{false, true, true});
+  barch->predicted_table(predictedtable{false, true, false});
+  barch->refs_table(refstable{0U, 0U, 1U});
+  barch->append_line(first);
+  barch->append_line(coded);
+  barch->append_line(barchdata{});
+
+  barchdata buffer(stride * 3U, padding);
+
+  ASSERT_TRUE(conv->convert(barch, DecodeTarget{buffer.data(), buffer.size(),
+                                                stride, RowOrder::bottom_up}));
+
+  // The last row first, the padding bytes untouched
+  EXPECT_THAT(buffer, ElementsAre(1U, 0U, 3U, 4U, padding, padding,  //
+                                  1U, 0U, 3U, 4U, padding, padding,  //
+                                  1U, 2U, 3U, 4U, padding, padding));
+}
+
+TEST_F(UTEST_Barch2BMPConverter0, invalid_decode_target_failure)
+{
+  auto barch = BarchImage::create();
+  ASSERT_NE(barch, nullptr);
+
+  barch->width(4U);
+  barch->lines_table(linestable{false, false});
+  barch->append_line(barchdata{1U, 2U, 3U, 4U});
+  barch->append_line(barchdata{1U, 2U, 3U, 4U});
+
+  barchdata buffer(16U);
+
+  EXPECT_FALSE(conv->convert(barch, DecodeTarget{nullptr, 16U, 8U}));
+  // The stride below the width
+  EXPECT_FALSE(conv->convert(barch, DecodeTarget{buffer.data(), 16U, 3U}));
+  // The last row does not fit
+  EXPECT_FALSE(conv->convert(barch, DecodeTarget{buffer.data(), 11U, 8U}));
+  EXPECT_TRUE(conv->convert(barch, DecodeTarget{buffer.data(), 12U, 8U}));
+}
@@ -0,0 +1,114 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "src/lib/libmain/converters/CodecDispatch.h"
+
+using namespace barchclib0::converters;
+using namespace testing;
+
+class UTEST_CodecDispatch : public Test
+{
+ public:
+  static constexpr const size_t group = 4U;
+
+  /// @brief The rows with the uniform groups and the single odd pixels
+  static std::vector<unsigned char> random_row(std::mt19937& gen,
+                                               const size_t& groups)
+  {
+    std::uniform_int_distribution<int> kind{0, 3};
+    std::uniform_int_distribution<int> value{0, 255};
+    std::vector<unsigned char> row(groups * group);
+
+    for (size_t iter = 0U; iter < groups; ++iter) {
+      const int k = kind(gen);
+      const unsigned char base = k == 0 ? 255U : 0U;
+
+      for (size_t pix = 0U; pix < group; ++pix) {
+        row[iter * group + pix] = base;
+      }
+
+      if (k >= 2) {
+        row[iter * group + static_cast<size_t>(value(gen)) % group] =
+            static_cast<unsigned char>(value(gen));
+      }
+    }
+
+    return row;
+  }
+};
+
+TEST_F(UTEST_CodecDispatch, best_table_is_supported_success)
+{
+  const auto tables = supported_codec_dispatches();
+
+  ASSERT_FALSE(tables.empty());
+  EXPECT_EQ(tables.front().isa, CodecIsa::scalar);
+  EXPECT_EQ(codec_dispatch().isa, tables.back().isa);
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+TEST_F(UTEST_CodecDispatch, sse2_table_on_x86_64_success)
+{
+  // Every x86-64 CPU has SSE2, the vector tier is always there
+  const auto tables = supported_codec_dispatches();
+
+  ASSERT_GE(tables.size(), 2U);
+  EXPECT_EQ(tables[1U].isa, CodecIsa::sse2);
+}
+#endif
+
+TEST_F(UTEST_CodecDispatch, classify_variants_match_scalar_success)
+{
+  std::mt19937 gen{11U};
+  const auto tables = supported_codec_dispatches();
+
+  for (size_t groups = 0U; groups < 70U; ++groups) {
+    const auto row = random_row(gen, groups);
+
+    std::vector<unsigned char> expected(groups, 1U);
+    tables.front().classify_groups(row.data(), groups, expected.data());
+
+    for (const auto& table : tables) {
+      std::vector<unsigned char> codes(groups, 1U);
+
+      table.classify_groups(row.data(), groups, codes.data());
+
+      EXPECT_EQ(codes, expected) << "ISA " << static_cast<int>(table.isa)
+                                 << " groups " << groups;
+    }
+  }
+}
+
+TEST_F(UTEST_CodecDispatch, classify_codes_success)
+{
+  const std::vector<unsigned char> row{255U, 255U, 255U, 255U, 0U, 0U,
+                                       0U,   0U,   0U,   255U, 0U, 0U};
+
+  for (const auto& table : supported_codec_dispatches()) {
+    std::vector<unsigned char> codes(3U, 1U);
+
+    table.classify_groups(row.data(), codes.size(), codes.data());
+
+    EXPECT_THAT(codes, ElementsAre(0U, 2U, 3U));
+  }
+}
+
+TEST_F(UTEST_CodecDispatch, fill_variants_success)
+{
+  for (const auto& table : supported_codec_dispatches()) {
+    for (size_t count = 0U; count < 200U; count += 7U) {
+      std::vector<unsigned char> dst(count + 2U, 7U);
+
+      table.fill_pixels(dst.data() + 1U, count, 255U);
+
+      EXPECT_EQ(dst.front(), 7U);
+      EXPECT_EQ(dst.back(), 7U);
+      EXPECT_EQ(std::count(dst.begin(), dst.end(), 255U),
+                static_cast<std::ptrdiff_t>(count));
+    }
+  }
+}
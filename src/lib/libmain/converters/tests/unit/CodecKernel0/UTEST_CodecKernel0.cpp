@@ -0,0 +1,309 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "src/lib/libmain/converters/CodecKernel0.h"
+
+using namespace barchclib0;
+using namespace barchclib0::converters;
+using namespace testing;
+
+class UTEST_CodecKernel0 : public Test
+{
+ public:
+  using kernel = CodecKernel0<4U, 8U, 2U>;
+  using runs_kernel = CodecKernel0<4U, 8U, 2U, true>;
+
+  static constexpr const unsigned char white = 255U;
+  static constexpr const unsigned char black = 0U;
+  static constexpr const unsigned char gray = 127U;
+};
+
+TEST_F(UTEST_CodecKernel0, whites_and_blacks_groups_encode_success)
+{
+  const barchdata row{white, white, white, white, black, black, black, black};
+  barchdata comp{1U, 2U, 3U};
+
+  kernel::encode_row(row.data(), row.size(), comp);
+
+  ASSERT_EQ(comp.size(), 1U);
+  EXPECT_EQ(comp[0], 0B01000000);
+}
+
+TEST_F(UTEST_CodecKernel0, as_is_tail_padded_to_group_success)
+{
+  const barchdata row{gray, gray, gray, gray, white};
+  barchdata comp;
+
+  kernel::encode_row(row.data(), row.size(), comp);
+
+  // 2 + 32 bits of the whole group, 2 + 8 bits of the tail padded to the
+  // byte and zero bytes up to the group size
+  EXPECT_EQ(comp.size(), 9U);
+  EXPECT_EQ(comp[0], 0B11011111);
+  EXPECT_EQ(comp[4], 0B11111111);
+  EXPECT_EQ(comp[5], 0B11110000);
+}
+
+TEST_F(UTEST_CodecKernel0, optimal_to_compress_success)
+{
+  const barchdata runs{white, white, white, white, gray, black,
+                       black, black, black};
+  const barchdata broken{white, white, white, black, white, black,
+                         black, black, gray};
+
+  EXPECT_TRUE(kernel::optimal_to_compress(runs.data(), runs.size()));
+  EXPECT_FALSE(kernel::optimal_to_compress(broken.data(), broken.size()));
+}
+
+TEST_F(UTEST_CodecKernel0, random_rows_roundtrip_success)
+{
+  std::mt19937 gen{7U};
+  std::uniform_int_distribution<int> kind{0, 2};
+  std::uniform_int_distribution<int> value{0, 255};
+
+  for (size_t width = 1U; width < 67U; ++width) {
+    barchdata row(width);
+
+    for (auto& pix : row) {
+      const int k = kind(gen);
+      pix = k == 0   ? white
+            : k == 1 ? black
+                     : static_cast<unsigned char>(value(gen));
+    }
+
+    barchdata comp;
+    kernel::encode_row(row.data(), row.size(), comp);
+
+    // The exact size and the precomputed codes agree with the encoding
+    barchdata codes(kernel::groups_count(width));
+    barchdata fromcodes;
+
+    kernel::classify_row(row.data(), width, codes.data());
+    kernel::encode_row(row.data(), width, codes.data(), fromcodes);
+
+    EXPECT_EQ(kernel::encoded_size(codes.data(), width), comp.size());
+    EXPECT_EQ(fromcodes, comp);
+
+    barchdata restored(width, gray);
+
+    EXPECT_EQ(kernel::decode_row(comp.data(), comp.size(), restored.data(),
+                                 width),
+              width);
+    EXPECT_EQ(restored, row) << "Width " << width;
+
+    // The row size is found in the middle of the stream too
+    barchdata stream = comp;
+    stream.insert(stream.end(), comp.begin(), comp.end());
+
+    EXPECT_EQ(kernel::encoded_row_size(stream.data(), stream.size(), width),
+              comp.size())
+        << "Width " << width;
+  }
+}
+
+TEST_F(UTEST_CodecKernel0, truncated_row_decode_success)
+{
+  const barchdata row{gray, gray, gray, gray, white, white, white, white};
+  barchdata comp;
+
+  kernel::encode_row(row.data(), row.size(), comp);
+
+  barchdata restored(row.size(), black);
+
+  EXPECT_EQ(kernel::decode_row(comp.data(), 3U, restored.data(), row.size()),
+            2U);
+  EXPECT_EQ(restored[0], gray);
+  EXPECT_EQ(restored[1], gray);
+  EXPECT_EQ(kernel::encoded_row_size(comp.data(), 3U, row.size()), 3U);
+}
+
+TEST_F(UTEST_CodecKernel0, long_runs_white_row_encode_success)
+{
+  const barchdata row(256U, white);
+  barchdata comp;
+  barchdata runs;
+
+  kernel::encode_row(row.data(), row.size(), comp);
+  runs_kernel::encode_row(row.data(), row.size(), runs);
+
+  EXPECT_EQ(comp.size(), 8U);
+  // 111, the white bit and the Exp-Golomb of 64 - 4 groups: 00000111101
+  EXPECT_THAT(runs, ElementsAre(0B11100000, 0B01111010));
+
+  barchdata restored(row.size(), gray);
+
+  EXPECT_EQ(runs_kernel::decode_row(runs.data(), runs.size(), restored.data(),
+                                    restored.size()),
+            row.size());
+  EXPECT_EQ(restored, row);
+}
+
+TEST_F(UTEST_CodecKernel0, long_runs_short_spans_stay_single_success)
+{
+  // The 4 groups run costs more than the 4 single white codes
+  const barchdata row{white, white, white, white, white, white, white, white,
+                      white, white, white, white, white, white, white, white};
+  barchdata runs;
+
+  runs_kernel::encode_row(row.data(), row.size(), runs);
+
+  EXPECT_THAT(runs, ElementsAre(0B00000000));
+}
+
+TEST_F(UTEST_CodecKernel0, long_runs_random_rows_roundtrip_success)
+{
+  std::mt19937 gen{13U};
+  std::uniform_int_distribution<int> kind{0, 2};
+  std::uniform_int_distribution<int> span{1, 400};
+  std::uniform_int_distribution<int> value{0, 255};
+
+  for (size_t width = 1U; width < 2000U; width += 37U) {
+    barchdata row;
+
+    while (row.size() < width) {
+      const int k = kind(gen);
+      const auto count = std::min(static_cast<size_t>(span(gen)),
+                                  width - row.size());
+
+      for (size_t pix = 0U; pix < count; ++pix) {
+        row.emplace_back(k == 0   ? white
+                         : k == 1 ? black
+                                  : static_cast<unsigned char>(value(gen)));
+      }
+    }
+
+    barchdata comp;
+    barchdata runs;
+
+    kernel::encode_row(row.data(), width, comp);
+    runs_kernel::encode_row(row.data(), width, runs);
+
+    barchdata codes(runs_kernel::groups_count(width));
+    barchdata fromcodes;
+
+    runs_kernel::classify_row(row.data(), width, codes.data());
+    runs_kernel::encode_row(row.data(), width, codes.data(), fromcodes);
+
+    EXPECT_EQ(runs_kernel::encoded_size(codes.data(), width), runs.size());
+    EXPECT_EQ(fromcodes, runs);
+
+    barchdata restored(width, gray);
+
+    EXPECT_EQ(runs_kernel::decode_row(runs.data(), runs.size(),
+                                      restored.data(), width),
+              width);
+    EXPECT_EQ(restored, row) << "Width " << width;
+
+    barchdata stream = runs;
+    stream.insert(stream.end(), runs.begin(), runs.end());
+
+    EXPECT_EQ(
+        runs_kernel::encoded_row_size(stream.data(), stream.size(), width),
+        runs.size())
+        << "Width " << width;
+  }
+}
+
+TEST_F(UTEST_CodecKernel0, huffman_table_random_rows_roundtrip_success)
+{
+  std::mt19937 gen{17U};
+  std::uniform_int_distribution<int> kind{0, 2};
+  std::normal_distribution<double> value{127.0, 6.0};
+
+  PixelHuffman0::counts counts{};
+  std::vector<barchdata> rows;
+
+  for (size_t width = 1U; width < 300U; width += 11U) {
+    barchdata row(width);
+
+    for (auto& pix : row) {
+      const int k = kind(gen);
+      pix = k == 0   ? white
+            : k == 1 ? black
+                     : static_cast<unsigned char>(
+                           std::clamp(value(gen), 1.0, 254.0));
+      ++counts[pix];
+    }
+
+    rows.emplace_back(std::move(row));
+  }
+
+  const PixelHuffman0 table = PixelHuffman0::build(counts);
+
+  for (const auto& row : rows) {
+    const size_t width = row.size();
+
+    barchdata codes(runs_kernel::groups_count(width));
+    barchdata comp;
+
+    runs_kernel::classify_row(row.data(), width, codes.data());
+    runs_kernel::encode_row(row.data(), width, codes.data(), comp, &table);
+
+    EXPECT_EQ(runs_kernel::encoded_size(row.data(), codes.data(), width, table),
+              comp.size());
+
+    barchdata restored(width, gray);
+
+    EXPECT_EQ(runs_kernel::decode_row(comp.data(), comp.size(),
+                                      restored.data(), width, &table),
+              width);
+    EXPECT_EQ(restored, row) << "Width " << width;
+
+    barchdata stream = comp;
+    stream.insert(stream.end(), comp.begin(), comp.end());
+
+    EXPECT_EQ(runs_kernel::encoded_row_size(stream.data(), stream.size(),
+                                            width, &table),
+              comp.size())
+        << "Width " << width;
+  }
+}
+
+TEST_F(UTEST_CodecKernel0, sampled_decode_matches_full_decode_success)
+{
+  std::mt19937 gen{19U};
+  std::uniform_int_distribution<int> kind{0, 2};
+  std::uniform_int_distribution<int> span{1, 90};
+  std::uniform_int_distribution<int> value{0, 255};
+
+  for (size_t width = 1U; width < 700U; width += 23U) {
+    barchdata row;
+
+    while (row.size() < width) {
+      const int k = kind(gen);
+      const auto count = std::min(static_cast<size_t>(span(gen)),
+                                  width - row.size());
+
+      for (size_t pix = 0U; pix < count; ++pix) {
+        row.emplace_back(k == 0   ? white
+                         : k == 1 ? black
+                                  : static_cast<unsigned char>(value(gen)));
+      }
+    }
+
+    barchdata runs;
+
+    runs_kernel::encode_row(row.data(), width, runs);
+
+    for (const size_t step : {1U, 2U, 4U, 8U}) {
+      const size_t first = (width / 3U) % 7U;
+
+      barchdata expected;
+
+      for (size_t col = first; col < width; col += step) {
+        expected.push_back(row[col]);
+      }
+
+      barchdata sampled(expected.size(), gray);
+
+      EXPECT_EQ(runs_kernel::decode_row_sampled(runs.data(), runs.size(),
+                                                sampled.data(), first, width,
+                                                step),
+                expected.size());
+      EXPECT_EQ(sampled, expected) << "Width " << width << " step " << step;
+    }
+  }
+}
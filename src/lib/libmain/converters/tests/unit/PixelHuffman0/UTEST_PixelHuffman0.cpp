@@ -0,0 +1,90 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "src/lib/libmain/converters/PixelHuffman0.h"
+
+using namespace barchclib0::converters;
+using namespace testing;
+
+class UTEST_PixelHuffman0 : public Test
+{
+};
+
+TEST_F(UTEST_PixelHuffman0, frequent_values_get_short_codes_success)
+{
+  PixelHuffman0::counts counts{};
+  counts[127U] = 100000U;
+  counts[128U] = 50000U;
+  counts[3U] = 10U;
+
+  const PixelHuffman0 huffman = PixelHuffman0::build(counts);
+
+  EXPECT_LT(huffman.length(127U), huffman.length(3U));
+  EXPECT_LE(huffman.length(127U), huffman.length(128U));
+
+  // Every value is coded and the lookup resolves every code
+  for (unsigned int value = 0U; value < PixelHuffman0::symbols; ++value) {
+    const auto pixel = static_cast<unsigned char>(value);
+    const unsigned int length = huffman.length(pixel);
+
+    ASSERT_GT(length, 0U);
+
+    const uint16_t entry = huffman.lookup(
+        huffman.code(pixel) << (PixelHuffman0::max_code_bits - length));
+
+    EXPECT_EQ(entry & 0xFFU, value);
+    EXPECT_EQ(entry >> 8U, length);
+  }
+}
+
+TEST_F(UTEST_PixelHuffman0, skewed_counts_limited_lengths_success)
+{
+  PixelHuffman0::counts counts{};
+  uint64_t count = 1U;
+  uint64_t prev = 0U;
+
+  // The Fibonacci counts give the deepest plain Huffman tree
+  for (size_t iter = 0U; iter < 40U; ++iter) {
+    counts[iter] = count;
+    const uint64_t next = count + prev;
+    prev = count;
+    count = next;
+  }
+
+  const PixelHuffman0 huffman = PixelHuffman0::build(counts);
+  const auto& lengths = huffman.lengths();
+
+  EXPECT_LE(*std::max_element(lengths.cbegin(), lengths.cend()),
+            PixelHuffman0::max_code_bits);
+
+  PixelHuffman0 restored;
+
+  ASSERT_TRUE(restored.assign(lengths.data(), lengths.size()));
+
+  for (unsigned int value = 0U; value < PixelHuffman0::symbols; ++value) {
+    const auto pixel = static_cast<unsigned char>(value);
+
+    EXPECT_EQ(restored.code(pixel), huffman.code(pixel));
+  }
+}
+
+TEST_F(UTEST_PixelHuffman0, oversubscribed_lengths_assign_failure)
+{
+  PixelHuffman0::lengthstable lengths{};
+  lengths.fill(7U);
+
+  PixelHuffman0 huffman;
+
+  EXPECT_FALSE(huffman.assign(lengths.data(), lengths.size()));
+
+  lengths.fill(8U);
+
+  EXPECT_TRUE(huffman.assign(lengths.data(), lengths.size()));
+  EXPECT_FALSE(huffman.assign(lengths.data(), lengths.size() - 1U));
+
+  lengths[0] = PixelHuffman0::max_code_bits + 1U;
+
+  EXPECT_FALSE(huffman.assign(lengths.data(), lengths.size()));
+}
@@ -0,0 +1,110 @@
+#include "src/lib/libmain/executor/ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "src/log/log.h"
+#include "src/log/trace.h"
+
+namespace barchclib0::executor
+{
+
+ThreadPool::ThreadPool(const size_t& threads)
+    : mstate{std::make_shared<State>()}
+{
+  const size_t count = resolve_size(threads);
+
+  mworkers.reserve(count);
+
+  for (size_t iter = 0U; iter < count; ++iter) {
+    mworkers.emplace_back(&ThreadPool::work, mstate);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> guard{mstate->m};
+    mstate->stop = true;
+  }
+
+  mstate->cv.notify_all();
+
+  for (auto& worker : mworkers) {
+    if (worker.get_id() == std::this_thread::get_id()) {
+      worker.detach();
+    } else if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+ThreadPoolPtr ThreadPool::create(const size_t& threads)
+{
+  return std::make_shared<ThreadPool>(threads);
+}
+
+size_t ThreadPool::resolve_size(const size_t& threads)
+{
+  if (threads != 0U) {
+    return threads;
+  }
+
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+size_t ThreadPool::size() const { return mworkers.size(); }
+
+void ThreadPool::post(task ntask)
+{
+  if (ntask == nullptr) {
+    LOGE("Empty task provided");
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard{mstate->m};
+    mstate->tasks.emplace_back(std::move(ntask));
+  }
+
+  mstate->cv.notify_one();
+}
+
+void ThreadPool::work(std::shared_ptr<State> state)
+{
+  TRACE_THREAD_NAME("Library executor");
+
+  for (;;) {
+    task current;
+
+    {
+      std::unique_lock<std::mutex> lock{state->m};
+
+      state->cv.wait(lock,
+                     [&state] { return state->stop || !state->tasks.empty(); });
+
+      if (state->tasks.empty()) {
+        return;
+      }
+
+      current = std::move(state->tasks.front());
+      state->tasks.pop_front();
+    }
+
+    try {
+      current();
+    }
+    catch (const std::exception& e) {
+      LOGE("Exception in the executor task: " << e.what());
+    }
+    catch (...) {
+      LOGE("Unknown exception in the executor task");
+    }
+  }
+}
+
+}  // namespace barchclib0::executor
@@ -0,0 +1,90 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_THREADPOOL_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_THREADPOOL_CLASS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace barchclib0::executor
+{
+
+/**
+ * @brief The library owned fixed size executor for the asynchronous
+ * operations. Queued tasks are finished before the destruction. If the last
+ * pool reference is dropped by its own task, the calling worker is detached
+ * and finishes the queue alone.
+ */
+class ThreadPool : public std::enable_shared_from_this<ThreadPool>
+{
+ public:
+  using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+  using task = std::function<void()>;
+
+  virtual ~ThreadPool();
+
+  /// @param threads The workers count. Zero means the hardware concurrency.
+  explicit ThreadPool(const size_t& threads);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Queues the callable for the execution.
+   *
+   * @return Returns the future of the callable result. Exceptions thrown by
+   * the callable are stored in the future.
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& callable)
+  {
+    using result = std::invoke_result_t<F>;
+
+    auto ptask = std::make_shared<std::packaged_task<result()>>(
+        std::forward<F>(callable));
+    std::future<result> future = ptask->get_future();
+
+    post([ptask]() { (*ptask)(); });
+
+    return future;
+  }
+
+  /// @brief Queues the fire-and-forget task.
+  virtual void post(task ntask);
+
+  /// @brief The workers count.
+  size_t size() const;
+
+  /// @brief The resolved workers count for the requested one.
+  static size_t resolve_size(const size_t& threads);
+
+  static ThreadPoolPtr create(const size_t& threads = 0U);
+
+ private:
+  /// @brief The queue shared with the workers, outlives a detached worker.
+  struct State
+  {
+    std::deque<task> tasks;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stop{false};
+  };
+
+  static void work(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> mstate;
+  std::vector<std::thread> mworkers;
+};
+
+using ThreadPoolPtr = ThreadPool::ThreadPoolPtr;
+
+}  // namespace barchclib0::executor
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_THREADPOOL_CLASS_H
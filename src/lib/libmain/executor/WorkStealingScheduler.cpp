@@ -0,0 +1,233 @@
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "src/log/log.h"
+#include "src/log/trace.h"
+
+namespace barchclib0::executor
+{
+
+namespace
+{
+
+void run_task(const WorkStealingScheduler::task& current)
+{
+  try {
+    current();
+  }
+  catch (const std::exception& e) {
+    LOGE("Exception in the scheduler task: " << e.what());
+  }
+  catch (...) {
+    LOGE("Unknown exception in the scheduler task");
+  }
+}
+
+}  // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(const size_t& threads)
+{
+  const size_t count =
+      threads != 0U ? threads
+                    : std::max(1U, std::thread::hardware_concurrency());
+
+  mqueues.reserve(count);
+
+  for (size_t iter = 0U; iter < count; ++iter) {
+    mqueues.emplace_back(std::make_unique<Worker>());
+  }
+
+  mworkers.reserve(count);
+
+  for (size_t iter = 0U; iter < count; ++iter) {
+    mworkers.emplace_back(&WorkStealingScheduler::work, this, iter);
+  }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+  {
+    std::lock_guard<std::mutex> guard{msleepm};
+    mstop = true;
+  }
+
+  msleepcv.notify_all();
+
+  for (auto& worker : mworkers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+WorkStealingSchedulerPtr WorkStealingScheduler::create(const size_t& threads)
+{
+  return std::make_shared<WorkStealingScheduler>(threads);
+}
+
+WorkStealingScheduler* WorkStealingScheduler::current() { return tlscheduler; }
+
+size_t WorkStealingScheduler::size() const { return mworkers.size(); }
+
+void WorkStealingScheduler::spawn(task ntask)
+{
+  if (ntask == nullptr) {
+    LOGE("Empty task provided");
+    return;
+  }
+
+  const size_t index =
+      tlscheduler == this ? tlsindex : mnext.fetch_add(1U) % mqueues.size();
+
+  {
+    std::lock_guard<std::mutex> guard{msleepm};
+    ++mqueued;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard{mqueues[index]->m};
+    mqueues[index]->tasks.emplace_back(std::move(ntask));
+  }
+
+  msleepcv.notify_one();
+}
+
+void WorkStealingScheduler::parallel_for(const size_t& begin,
+                                         const size_t& end,
+                                         const size_t& grain,
+                                         const range_body& body)
+{
+  if (end <= begin || body == nullptr) {
+    return;
+  }
+
+  const size_t step = std::max<size_t>(1U, grain);
+  const size_t chunks = (end - begin + step - 1U) / step;
+
+  if (chunks == 1U) {
+    body(begin, end);
+    return;
+  }
+
+  std::atomic<size_t> remaining{chunks};
+  std::exception_ptr error;
+  std::mutex errorm;
+
+  const auto run_chunk = [&](const size_t& chunk) {
+    const size_t cbegin = begin + chunk * step;
+    const size_t cend = std::min(end, cbegin + step);
+
+    try {
+      body(cbegin, cend);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> guard{errorm};
+
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+
+    --remaining;
+  };
+
+  for (size_t chunk = 1U; chunk < chunks; ++chunk) {
+    spawn([&run_chunk, chunk]() { run_chunk(chunk); });
+  }
+
+  run_chunk(0U);
+
+  help_until([&remaining]() { return remaining.load() == 0U; });
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkStealingScheduler::help_until(const std::function<bool()>& done)
+{
+  while (!done()) {
+    task current;
+
+    if (take(current)) {
+      run_task(current);
+    } else {
+      idle(help_wait);
+    }
+  }
+}
+
+bool WorkStealingScheduler::take(task& dst)
+{
+  const size_t count = mqueues.size();
+  const bool own = tlscheduler == this;
+  const size_t start = own ? tlsindex : mnext.load() % count;
+
+  if (own) {
+    Worker& worker = *mqueues[start];
+    std::lock_guard<std::mutex> guard{worker.m};
+
+    if (!worker.tasks.empty()) {
+      dst = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      --mqueued;
+      return true;
+    }
+  }
+
+  for (size_t iter = own ? 1U : 0U; iter < count; ++iter) {
+    Worker& victim = *mqueues[(start + iter) % count];
+    std::lock_guard<std::mutex> guard{victim.m};
+
+    if (!victim.tasks.empty()) {
+      dst = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      --mqueued;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkStealingScheduler::idle(const std::chrono::microseconds& limit)
+{
+  std::unique_lock<std::mutex> lock{msleepm};
+
+  msleepcv.wait_for(lock, limit,
+                    [this]() { return mstop || mqueued.load() > 0U; });
+}
+
+void WorkStealingScheduler::work(const size_t& index)
+{
+  TRACE_THREAD_NAME("Library scheduler");
+
+  tlscheduler = this;
+  tlsindex = index;
+
+  for (;;) {
+    task current;
+
+    if (take(current)) {
+      run_task(current);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock{msleepm};
+
+    msleepcv.wait(lock, [this]() { return mstop || mqueued.load() > 0U; });
+
+    if (mstop && mqueued.load() == 0U) {
+      return;
+    }
+  }
+}
+
+}  // namespace barchclib0::executor
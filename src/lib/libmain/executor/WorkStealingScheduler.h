@@ -0,0 +1,114 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_WORKSTEALINGSCHEDULER_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_WORKSTEALINGSCHEDULER_CLASS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace barchclib0::executor
+{
+
+/**
+ * @brief The work-stealing task scheduler under the batch and the row
+ * conversions. Every worker owns a task deque: it takes its own tasks from
+ * the back and steals the oldest ones from the front of the other deques, so
+ * the row-range tasks of a giant image spread over the idle workers while the
+ * small files run as the whole-file tasks.
+ *
+ * The waiting calls run the queued tasks themselves instead of blocking, so
+ * the nested parallel loops from the worker threads never deadlock.
+ */
+class WorkStealingScheduler
+    : public std::enable_shared_from_this<WorkStealingScheduler>
+{
+ public:
+  using WorkStealingSchedulerPtr = std::shared_ptr<WorkStealingScheduler>;
+  using task = std::function<void()>;
+  using range_body = std::function<void(size_t, size_t)>;
+
+  /**
+   * @brief Finishes the queued tasks and joins the workers. Must not be
+   * called from the own tasks.
+   */
+  virtual ~WorkStealingScheduler();
+
+  /// @param threads The workers count. Zero means the hardware concurrency.
+  explicit WorkStealingScheduler(const size_t& threads);
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  /**
+   * @brief Queues the task. From a worker thread the task goes into its own
+   * deque, otherwise the deques are filled in turn.
+   */
+  virtual void spawn(task ntask);
+
+  /**
+   * @brief Runs the body over the [begin, end) range split into the grain
+   * sized chunks. Blocks until all the chunks are done, running the queued
+   * tasks meanwhile. The first exception of the body is rethrown.
+   */
+  virtual void parallel_for(const size_t& begin, const size_t& end,
+                            const size_t& grain, const range_body& body);
+
+  /**
+   * @brief Runs the queued tasks until the predicate is satisfied. For the
+   * waits on the tasks of this scheduler only.
+   */
+  void help_until(const std::function<bool()>& done);
+
+  /// @brief The workers count.
+  size_t size() const;
+
+  /// @brief The scheduler of the calling worker thread, nullptr elsewhere.
+  static WorkStealingScheduler* current();
+
+  static WorkStealingSchedulerPtr create(const size_t& threads = 0U);
+
+ private:
+  struct Worker
+  {
+    std::deque<task> tasks;
+    std::mutex m;
+  };
+
+  void work(const size_t& index);
+
+  /// @brief Takes the own newest task or steals the oldest one.
+  bool take(task& dst);
+
+  /// @brief Waits for a new task up to the given time.
+  void idle(const std::chrono::microseconds& limit);
+
+  inline static constexpr const std::chrono::microseconds help_wait{200};
+
+  inline static thread_local WorkStealingScheduler* tlscheduler{nullptr};
+  inline static thread_local size_t tlsindex{0U};
+
+  std::vector<std::unique_ptr<Worker>> mqueues;
+  std::atomic<size_t> mnext{0U};
+
+  // The queued tasks count, incremented under the sleep mutex to not lose
+  // the wakeups
+  std::atomic<size_t> mqueued{0U};
+  std::mutex msleepm;
+  std::condition_variable msleepcv;
+  bool mstop{false};
+
+  std::vector<std::thread> mworkers;
+};
+
+using WorkStealingSchedulerPtr =
+    WorkStealingScheduler::WorkStealingSchedulerPtr;
+
+}  // namespace barchclib0::executor
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_WORKSTEALINGSCHEDULER_CLASS_H
@@ -0,0 +1,109 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/lib/libmain/executor/ThreadPool.h"
+using namespace barchclib0::executor;
+using namespace testing;
+
+class UTEST_ThreadPool : public Test
+{
+ public:
+  static constexpr const size_t tasksCount = 64U;
+  static constexpr const size_t threadsCount = 3U;
+  static constexpr const int rndvalue = 123;
+  static constexpr const std::chrono::seconds waitLimit{30};
+};
+
+TEST_F(UTEST_ThreadPool, resolve_size)
+{
+  EXPECT_EQ(ThreadPool::resolve_size(threadsCount), threadsCount);
+  EXPECT_GE(ThreadPool::resolve_size(0U), 1U);
+
+  auto pool = ThreadPool::create(threadsCount);
+
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(pool->size(), threadsCount);
+  EXPECT_GE(ThreadPool::create()->size(), 1U);
+}
+
+TEST_F(UTEST_ThreadPool, submit_result)
+{
+  auto pool = ThreadPool::create(threadsCount);
+  std::vector<std::future<size_t>> futures;
+
+  for (size_t iter = 0U; iter < tasksCount; ++iter) {
+    futures.emplace_back(pool->submit([iter]() { return iter * iter; }));
+  }
+
+  for (size_t iter = 0U; iter < tasksCount; ++iter) {
+    ASSERT_EQ(futures[iter].wait_for(waitLimit), std::future_status::ready);
+    EXPECT_EQ(futures[iter].get(), iter * iter);
+  }
+}
+
+TEST_F(UTEST_ThreadPool, submit_exception)
+{
+  auto pool = ThreadPool::create(1U);
+
+  auto failed =
+      pool->submit([]() -> int { throw std::runtime_error("failure"); });
+  auto next = pool->submit([]() { return rndvalue; });
+
+  EXPECT_THROW(failed.get(), std::runtime_error);
+  EXPECT_EQ(next.get(), rndvalue);
+}
+
+TEST_F(UTEST_ThreadPool, post_failure_keeps_workers)
+{
+  auto pool = ThreadPool::create(1U);
+
+  pool->post(nullptr);
+  pool->post([]() { throw std::runtime_error("failure"); });
+
+  EXPECT_EQ(pool->submit([]() { return rndvalue; }).get(), rndvalue);
+}
+
+TEST_F(UTEST_ThreadPool, destructor_drains_queue)
+{
+  std::atomic<size_t> done{0U};
+
+  {
+    auto pool = ThreadPool::create(threadsCount);
+
+    for (size_t iter = 0U; iter < tasksCount; ++iter) {
+      pool->post([&done]() { ++done; });
+    }
+  }
+
+  EXPECT_EQ(done.load(), tasksCount);
+}
+
+TEST_F(UTEST_ThreadPool, destroyed_by_own_task)
+{
+  auto pool = ThreadPool::create(threadsCount);
+  std::promise<void> released;
+  // the promise outlives the test on the detached worker
+  auto finished = std::make_shared<std::promise<void>>();
+  std::shared_future<void> releasedFuture = released.get_future();
+  auto finishedFuture = finished->get_future();
+
+  pool->post([self = pool, releasedFuture, finished]() mutable {
+    releasedFuture.wait();
+    // the last reference is dropped on the own worker
+    self.reset();
+    finished->set_value();
+  });
+
+  pool.reset();
+  released.set_value();
+
+  EXPECT_EQ(finishedFuture.wait_for(waitLimit), std::future_status::ready);
+}
@@ -0,0 +1,152 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/lib/libmain/executor/WorkStealingScheduler.h"
+
+using namespace barchclib0::executor;
+using namespace testing;
+
+class UTEST_WorkStealingScheduler : public Test
+{
+ public:
+  static constexpr const size_t threadsCount = 3U;
+  static constexpr const size_t rangeSize = 1000U;
+  static constexpr const size_t outerTasks = 8U;
+  static constexpr const size_t grain = 7U;
+
+  UTEST_WorkStealingScheduler()
+      : scheduler{WorkStealingScheduler::create(threadsCount)}
+  {
+    EXPECT_NE(scheduler, nullptr);
+  }
+
+  WorkStealingSchedulerPtr scheduler;
+};
+
+TEST_F(UTEST_WorkStealingScheduler, size_and_current)
+{
+  EXPECT_EQ(scheduler->size(), threadsCount);
+  EXPECT_GE(WorkStealingScheduler::create()->size(), 1U);
+  EXPECT_EQ(WorkStealingScheduler::current(), nullptr);
+
+  std::atomic<WorkStealingScheduler*> seen{nullptr};
+  std::atomic_bool done{false};
+
+  scheduler->spawn([&]() {
+    seen.store(WorkStealingScheduler::current());
+    done.store(true);
+  });
+
+  // not helping: the task must run on a worker
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_EQ(seen.load(), scheduler.get());
+}
+
+TEST_F(UTEST_WorkStealingScheduler, parallel_for_covers_range_once)
+{
+  std::vector<std::atomic<size_t>> visits(rangeSize);
+
+  scheduler->parallel_for(0U, rangeSize, grain, [&](size_t begin, size_t end) {
+    for (size_t iter = begin; iter < end; ++iter) {
+      ++visits[iter];
+    }
+  });
+
+  for (const auto& visit : visits) {
+    EXPECT_EQ(visit.load(), 1U);
+  }
+}
+
+TEST_F(UTEST_WorkStealingScheduler, parallel_for_empty_and_single_chunk)
+{
+  size_t calls = 0U;
+
+  scheduler->parallel_for(3U, 3U, grain, [&](size_t, size_t) { ++calls; });
+  EXPECT_EQ(calls, 0U);
+
+  scheduler->parallel_for(0U, grain, grain, [&](size_t begin, size_t end) {
+    EXPECT_EQ(begin, 0U);
+    EXPECT_EQ(end, grain);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1U);
+}
+
+TEST_F(UTEST_WorkStealingScheduler, parallel_for_rethrows)
+{
+  EXPECT_THROW(scheduler->parallel_for(0U, rangeSize, grain,
+                                       [](size_t begin, size_t) {
+                                         if (begin == grain * 2U) {
+                                           throw std::runtime_error("fail");
+                                         }
+                                       }),
+               std::runtime_error);
+}
+
+TEST_F(UTEST_WorkStealingScheduler, nested_parallel_for_no_deadlock)
+{
+  std::atomic<size_t> total{0U};
+  std::atomic<size_t> finished{0U};
+
+  for (size_t outer = 0U; outer < outerTasks; ++outer) {
+    scheduler->spawn([&]() {
+      scheduler->parallel_for(0U, rangeSize, grain,
+                              [&](size_t begin, size_t end) {
+                                total += end - begin;
+                              });
+      ++finished;
+    });
+  }
+
+  scheduler->help_until([&]() { return finished.load() == outerTasks; });
+
+  EXPECT_EQ(total.load(), outerTasks * rangeSize);
+}
+
+TEST_F(UTEST_WorkStealingScheduler, idle_workers_steal_row_tasks)
+{
+  std::mutex m;
+  std::set<std::thread::id> threads;
+  std::atomic_bool done{false};
+
+  scheduler->spawn([&]() {
+    scheduler->parallel_for(0U, rangeSize / 10U, 1U, [&](size_t, size_t) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      std::lock_guard<std::mutex> guard{m};
+      threads.insert(std::this_thread::get_id());
+    });
+    done.store(true);
+  });
+
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_GT(threads.size(), 1U);
+}
+
+TEST_F(UTEST_WorkStealingScheduler, destructor_drains_queue)
+{
+  std::atomic<size_t> done{0U};
+
+  {
+    auto local = WorkStealingScheduler::create(threadsCount);
+
+    for (size_t iter = 0U; iter < rangeSize; ++iter) {
+      local->spawn([&done]() { ++done; });
+    }
+  }
+
+  EXPECT_EQ(done.load(), rangeSize);
+}
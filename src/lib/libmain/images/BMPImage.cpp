@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "src/log/log.h"
@@ -10,6 +11,11 @@
 namespace barchclib0
 {
 
+BMPImage::~BMPImage()
+{
+  memory::BufferPool::release_to(mpool, std::move(mdata));
+}
+
 BMPImagePtr BMPImage::create() { return std::make_shared<BMPImage>(); }
 
 size_t BMPImage::width() const { return mwidth; }
@@ -24,7 +30,11 @@ void BMPImage::height(const size_t& nheight) { mheight = nheight; }
 
 void BMPImage::data(const barchdata& ndata) { mdata = ndata; }
 
-void BMPImage::data(barchdata&& ndata) { mdata = std::move(ndata); }
+void BMPImage::data(barchdata&& ndata)
+{
+  memory::BufferPool::release_to(mpool, std::move(mdata));
+  mdata = std::move(ndata);
+}
 
 unsigned int BMPImage::bits_per_pixel() { return mbitspp; }
 
@@ -139,7 +149,12 @@ void BMPImage::clear()
   mheight = 0U;
   mbitspp = default_bits_per_pix;
   mpath.clear();
-  mdata.clear();
+  memory::BufferPool::release_to(mpool, std::move(mdata));
+  mdata = barchdata{};
 }
 
+void BMPImage::pool(const memory::BufferPoolPtr& npool) { mpool = npool; }
+
+const memory::BufferPoolPtr& BMPImage::pool() const { return mpool; }
+
 }  // namespace barchclib0
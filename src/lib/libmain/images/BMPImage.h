@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "IBarchImage.h"
+#include "src/lib/libmain/memory/BufferPool.h"
 
 namespace barchclib0
 {
@@ -19,7 +20,8 @@ class BMPImage : public std::enable_shared_from_this<BMPImage>,
  public:
   using BMPImagePtr = std::shared_ptr<BMPImage>;
 
-  virtual ~BMPImage() = default;
+  /// @brief Gives the pixels buffer back to the pool, if any
+  virtual ~BMPImage();
   BMPImage() = default;
 
   /*
@@ -53,6 +55,10 @@ class BMPImage : public std::enable_shared_from_this<BMPImage>,
 
   virtual void clear() override;
 
+  /// @brief The pool to give the buffers back to
+  virtual void pool(const memory::BufferPoolPtr& npool);
+  virtual const memory::BufferPoolPtr& pool() const;
+
  private:
   inline static constexpr const unsigned int default_bits_per_pix = 8U;
 
@@ -67,6 +73,8 @@ class BMPImage : public std::enable_shared_from_this<BMPImage>,
   std::filesystem::path mpath;
 
   barchdata mdata;
+
+  memory::BufferPoolPtr mpool;
 };
 
 using BMPImagePtr = BMPImage::BMPImagePtr;
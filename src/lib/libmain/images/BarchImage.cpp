@@ -1,8 +1,10 @@
 #include "src/lib/libmain/images/BarchImage.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "src/log/log.h"
@@ -10,6 +12,8 @@
 namespace barchclib0
 {
 
+BarchImage::~BarchImage() { release_buffers(); }
+
 BarchImagePtr BarchImage::create() { return std::make_shared<BarchImage>(); }
 
 size_t BarchImage::width() const { return mwidth; }
@@ -35,14 +39,14 @@ void BarchImage::height(const size_t& nheight) { mheight = nheight; }
 
 void BarchImage::data(const barchdata& ndata)
 {
-  mdata.clear();
+  release_buffers();
   mdata.emplace_back(ndata);
 }
 
 void BarchImage::data(barchdata&& ndata)
 {
-  mdata.clear();
-  mdata.emplace_back(ndata);
+  release_buffers();
+  mdata.emplace_back(std::move(ndata));
   ndata.clear();
 }
 
@@ -74,6 +78,20 @@ barchdata BarchImage::line(const size_t& row) const
   return mdata[row];
 }
 
+const barchdata& BarchImage::scanline(const size_t& row) const
+{
+  static const barchdata empty;
+
+  if (mdata.size() <= row) {
+    LOGE("Index " << row << " is out of range for max " << mdata.size());
+    return empty;
+  }
+
+  return mdata[row];
+}
+
+const barchscans& BarchImage::scanlines() const { return mdata; }
+
 void BarchImage::append_line(const barchdata& nline)
 {
   mdata.emplace_back(nline);
@@ -81,6 +99,13 @@ void BarchImage::append_line(const barchdata& nline)
   mheight++;
 }
 
+void BarchImage::append_line(barchdata&& nline)
+{
+  mdata.emplace_back(std::move(nline));
+
+  mheight++;
+}
+
 void BarchImage::filepath(const std::filesystem::path& npath) { mpath = npath; }
 const std::filesystem::path& BarchImage::filepath() const { return mpath; }
 
@@ -93,13 +118,142 @@ void BarchImage::lines_table(linestable&& ntable)
 
 const linestable& BarchImage::lines_table() const { return linest; }
 
+void BarchImage::fills_table(const fillstable& ntable) { fillst = ntable; }
+
+void BarchImage::fills_table(fillstable&& ntable)
+{
+  fillst = std::move(ntable);
+}
+
+const fillstable& BarchImage::fills_table() const { return fillst; }
+
+RowFill BarchImage::row_fill(const size_t& row) const
+{
+  return row < fillst.size() ? fillst[row] : RowFill::none;
+}
+
+bool BarchImage::has_fills() const
+{
+  return std::any_of(fillst.cbegin(), fillst.cend(),
+                     [](const RowFill& fill) { return fill != RowFill::none; });
+}
+
+void BarchImage::refs_table(const refstable& ntable) { refst = ntable; }
+
+void BarchImage::refs_table(refstable&& ntable) { refst = std::move(ntable); }
+
+const refstable& BarchImage::refs_table() const { return refst; }
+
+size_t BarchImage::row_ref(const size_t& row) const
+{
+  return row < refst.size() ? refst[row] : 0U;
+}
+
+bool BarchImage::has_refs() const
+{
+  return std::any_of(refst.cbegin(), refst.cend(),
+                     [](const size_t& ref) { return ref != 0U; });
+}
+
+void BarchImage::predicted_table(const predictedtable& ntable)
+{
+  predst = ntable;
+}
+
+void BarchImage::predicted_table(predictedtable&& ntable)
+{
+  predst = std::move(ntable);
+}
+
+const predictedtable& BarchImage::predicted_table() const { return predst; }
+
+bool BarchImage::row_predicted(const size_t& row) const
+{
+  return row < predst.size() && predst[row];
+}
+
+bool BarchImage::has_predicted() const
+{
+  return std::find(predst.cbegin(), predst.cend(), true) != predst.cend();
+}
+
+void BarchImage::entropy_lengths(const barchdata& nlengths)
+{
+  mentropy = nlengths;
+}
+
+const barchdata& BarchImage::entropy_lengths() const { return mentropy; }
+
+void BarchImage::quantization_error(const unsigned int& nerror)
+{
+  mquanterror = nerror;
+}
+
+unsigned int BarchImage::quantization_error() const { return mquanterror; }
+
+void BarchImage::thumbnail(barchdata&& npixels, const size_t& nwidth,
+                           const size_t& nheight)
+{
+  mthumbnail = std::move(npixels);
+  mthumbwidth = nwidth;
+  mthumbheight = nheight;
+}
+
+const barchdata& BarchImage::thumbnail() const { return mthumbnail; }
+
+size_t BarchImage::thumbnail_width() const { return mthumbwidth; }
+
+size_t BarchImage::thumbnail_height() const { return mthumbheight; }
+
+bool BarchImage::has_thumbnail() const
+{
+  return mthumbwidth > 0U && mthumbheight > 0U &&
+         mthumbnail.size() == mthumbwidth * mthumbheight;
+}
+
+bool BarchImage::has_payload(const size_t& row) const
+{
+  return row_fill(row) == RowFill::none && row_ref(row) == 0U;
+}
+
 void BarchImage::clear()
 {
   mwidth = 0U;
   mheight = 0U;
   mpath.clear();
-  mdata.clear();
+  mformat = BarchFormat::ba000;
+  release_buffers();
   linest.clear();
+  fillst.clear();
+  refst.clear();
+  predst.clear();
+  mentropy.clear();
+  mquanterror = 0U;
+  mthumbnail.clear();
+  mthumbwidth = 0U;
+  mthumbheight = 0U;
+}
+
+void BarchImage::format(const BarchFormat& nformat) { mformat = nformat; }
+
+BarchFormat BarchImage::format() const { return mformat; }
+
+void BarchImage::pool(const memory::BufferPoolPtr& npool) { mpool = npool; }
+
+const memory::BufferPoolPtr& BarchImage::pool() const { return mpool; }
+
+void BarchImage::release_buffers()
+{
+  if (mpool != nullptr) {
+    for (auto& line : mdata) {
+      mpool->release(std::move(line));
+    }
+
+    mpool->release(std::move(rdata));
+    rdata = barchdata{};
+  }
+
+  mdata.clear();
 }
 
 }  // namespace barchclib0
@@ -6,7 +6,9 @@
 #include <memory>
 #include <vector>
 
+#include "BarchFormat.h"
 #include "IBarchImage.h"
+#include "src/lib/libmain/memory/BufferPool.h"
 
 namespace barchclib0
 {
@@ -22,7 +24,24 @@ class BarchImage : public std::enable_shared_from_this<BarchImage>,
   using barchscans = std::vector<barchdata>;
   using linestable = std::vector<bool>;
 
-  virtual ~BarchImage() = default;
+  /// @brief The uniform rows stored without the payload
+  enum class RowFill : unsigned char
+  {
+    none = 0U,
+    whites,
+    blacks
+  };
+
+  using fillstable = std::vector<RowFill>;
+
+  /// @brief The distance up to the identical row, zero for none
+  using refstable = std::vector<size_t>;
+
+  /// @brief The rows coded as the residual against the row above
+  using predictedtable = std::vector<bool>;
+
+  /// @brief Gives the rows buffers back to the pool, if any
+  virtual ~BarchImage();
   BarchImage() = default;
 
   /*
@@ -48,18 +67,94 @@ class BarchImage : public std::enable_shared_from_this<BarchImage>,
   virtual void pixel(const PixelPtr& nval) override;
 
   virtual barchdata line(const size_t& row) const override;
+  /// @brief The row without the copy. Empty for the invalid row index.
+  virtual const barchdata& scanline(const size_t& row) const;
+  /// @brief All the stored buffers in order, without the concatenation
+  virtual const barchscans& scanlines() const;
 
   virtual void append_line(const barchdata& nline) override;
+  /// @brief Takes the row buffer over without the copy
+  virtual void append_line(barchdata&& nline);
 
   virtual void lines_table(const linestable& ntable);
   virtual void lines_table(linestable&& ntable);
   virtual const linestable& lines_table() const;
 
+  /**
+   * @brief The uniform rows table of the BA002 variant. Such rows are marked
+   * compressed in the lines table and have the empty scanline.
+   */
+  virtual void fills_table(const fillstable& ntable);
+  virtual void fills_table(fillstable&& ntable);
+  virtual const fillstable& fills_table() const;
+  /// @brief The row fill, none for the rows with the payload
+  virtual RowFill row_fill(const size_t& row) const;
+  /// @brief Any of the rows is stored as the uniform one
+  virtual bool has_fills() const;
+
+  /**
+   * @brief The repeated rows table of the BA003 variant. Such rows are
+   * marked compressed in the lines table and have the empty scanline.
+   */
+  virtual void refs_table(const refstable& ntable);
+  virtual void refs_table(refstable&& ntable);
+  virtual const refstable& refs_table() const;
+  /// @brief The distance up to the row the given one repeats, zero for none
+  virtual size_t row_ref(const size_t& row) const;
+  /// @brief Any of the rows is stored as the reference
+  virtual bool has_refs() const;
+
+  /**
+   * @brief The predicted rows table of the BA004 variant. Such rows are
+   * marked compressed in the lines table, the scanline keeps the residual.
+   */
+  virtual void predicted_table(const predictedtable& ntable);
+  virtual void predicted_table(predictedtable&& ntable);
+  virtual const predictedtable& predicted_table() const;
+  virtual bool row_predicted(const size_t& row) const;
+  virtual bool has_predicted() const;
+
+  /**
+   * @brief The Huffman code lengths of the 256 pixel values of the BA005
+   * variant, empty for the other variants
+   */
+  virtual void entropy_lengths(const barchdata& nlengths);
+  virtual const barchdata& entropy_lengths() const;
+
+  /**
+   * @brief The largest pixel change of the lossy quantization the image was
+   * encoded with, zero for the lossless encoding. Not stored in the file.
+   */
+  virtual void quantization_error(const unsigned int& nerror);
+  virtual unsigned int quantization_error() const;
+
+  /**
+   * @brief The tiny raw grayscale preview the writer embeds into the file,
+   * none by default. The pixels go row by row, nwidth per row.
+   */
+  virtual void thumbnail(barchdata&& npixels, const size_t& nwidth,
+                         const size_t& nheight);
+  virtual const barchdata& thumbnail() const;
+  virtual size_t thumbnail_width() const;
+  virtual size_t thumbnail_height() const;
+  virtual bool has_thumbnail() const;
+
+  /// @brief The row is neither the uniform nor the reference one
+  virtual bool has_payload(const size_t& row) const;
+
   virtual unsigned int bits_per_pixel() override;
   virtual void bits_per_pixel(const unsigned int& nbits) override;
 
   virtual void clear() override;
 
+  /// @brief The file format variant of the rows data, BA000 by default
+  virtual void format(const BarchFormat& nformat);
+  virtual BarchFormat format() const;
+
+  /// @brief The pool to give the buffers back to
+  virtual void pool(const memory::BufferPoolPtr& npool);
+  virtual const memory::BufferPoolPtr& pool() const;
+
  private:
   inline static constexpr const unsigned int default_bits_per_pix = 8U;
 
@@ -74,15 +169,42 @@ class BarchImage : public std::enable_shared_from_this<BarchImage>,
   /// in the image.
   linestable linest;
 
+  /// @brief The uniform rows table, empty when there are none.
+  fillstable fillst;
+
+  /// @brief The repeated rows table, empty when there are none.
+  refstable refst;
+
+  /// @brief The predicted rows table, empty when there are none.
+  predictedtable predst;
+
+  barchdata mentropy;
+
+  unsigned int mquanterror{0U};
+
+  barchdata mthumbnail;
+  size_t mthumbwidth{0U};
+  size_t mthumbheight{0U};
+
   std::filesystem::path mpath;
 
+  BarchFormat mformat{BarchFormat::ba000};
+
   /// @brief for the data() method
   barchdata rdata;
+
+  memory::BufferPoolPtr mpool;
+
+  void release_buffers();
 };
 
 using BarchImagePtr = BarchImage::BarchImagePtr;
 using barchscans = BarchImage::barchscans;
 using linestable = BarchImage::linestable;
+using fillstable = BarchImage::fillstable;
+using RowFill = BarchImage::RowFill;
+using refstable = BarchImage::refstable;
+using predictedtable = BarchImage::predictedtable;
 
 }  // namespace barchclib0
 
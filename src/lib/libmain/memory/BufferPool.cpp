@@ -0,0 +1,127 @@
+#include "src/lib/libmain/memory/BufferPool.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "src/log/log.h"
+
+namespace barchclib0::memory
+{
+
+BufferPool::BufferPool(const size_t& maxBytes) : mmaxbytes{maxBytes} {}
+
+BufferPoolPtr BufferPool::create(const size_t& maxBytes)
+{
+  return std::make_shared<BufferPool>(maxBytes);
+}
+
+size_t BufferPool::size_class(const size_t& capacity)
+{
+  size_t sclass = min_class;
+
+  while (sclass < capacity) {
+    sclass <<= 1U;
+  }
+
+  return sclass;
+}
+
+barchdata BufferPool::acquire(const size_t& capacity)
+{
+  const size_t sclass = size_class(capacity);
+
+  {
+    std::lock_guard<std::mutex> guard{mm};
+
+    auto found = mfree.find(sclass);
+
+    if (found != mfree.end() && !found->second.empty()) {
+      barchdata buffer = std::move(found->second.back());
+
+      found->second.pop_back();
+      mbytes -= buffer.capacity();
+      ++mhits;
+
+      return buffer;
+    }
+  }
+
+  ++mmisses;
+
+  barchdata buffer;
+
+  buffer.reserve(sclass);
+
+  return buffer;
+}
+
+void BufferPool::release(barchdata&& buffer)
+{
+  const size_t capacity = buffer.capacity();
+
+  if (capacity < min_class) {
+    return;
+  }
+
+  // The largest class fully covered by the capacity
+  size_t sclass = size_class(capacity);
+
+  if (sclass > capacity) {
+    sclass >>= 1U;
+  }
+
+  buffer.clear();
+
+  std::lock_guard<std::mutex> guard{mm};
+
+  if (mbytes + capacity > mmaxbytes) {
+    LOGT("Buffer pool is full, freeing " << capacity << " bytes");
+    return;
+  }
+
+  mbytes += capacity;
+  mfree[sclass].emplace_back(std::move(buffer));
+}
+
+void BufferPool::clear()
+{
+  std::lock_guard<std::mutex> guard{mm};
+
+  mfree.clear();
+  mbytes = 0U;
+}
+
+size_t BufferPool::cached_bytes() const
+{
+  std::lock_guard<std::mutex> guard{mm};
+
+  return mbytes;
+}
+
+size_t BufferPool::hits() const { return mhits.load(); }
+
+size_t BufferPool::misses() const { return mmisses.load(); }
+
+barchdata BufferPool::acquire_from(const BufferPoolPtr& pool,
+                                   const size_t& capacity)
+{
+  if (pool != nullptr) {
+    return pool->acquire(capacity);
+  }
+
+  barchdata buffer;
+
+  buffer.reserve(capacity);
+
+  return buffer;
+}
+
+void BufferPool::release_to(const BufferPoolPtr& pool, barchdata&& buffer)
+{
+  if (pool != nullptr) {
+    pool->release(std::move(buffer));
+  }
+}
+
+}  // namespace barchclib0::memory
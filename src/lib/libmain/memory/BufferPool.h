@@ -0,0 +1,86 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BUFFERPOOL_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BUFFERPOOL_CLASS_H
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "IBarchImage.h"
+
+namespace barchclib0::memory
+{
+
+/**
+ * @brief The size-class pool of the image buffers. The readers, the
+ * converters and the images take their row and pixel buffers here and the
+ * images give them back on the destruction, so the consecutive files of a
+ * similar size reuse the already faulted-in storage instead of the fresh
+ * allocations. Thread safe. The descendants may plug in another allocation
+ * strategy.
+ */
+class BufferPool : public std::enable_shared_from_this<BufferPool>
+{
+ public:
+  using BufferPoolPtr = std::shared_ptr<BufferPool>;
+
+  virtual ~BufferPool() = default;
+
+  /// @param maxBytes The cached storage limit, the excess is freed.
+  explicit BufferPool(const size_t& maxBytes = default_max_bytes);
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /// @brief Returns an empty buffer with the capacity of at least given.
+  virtual barchdata acquire(const size_t& capacity);
+
+  /// @brief Takes the buffer storage back for the reuse.
+  virtual void release(barchdata&& buffer);
+
+  /// @brief Frees all the cached buffers.
+  virtual void clear();
+
+  /// @brief The cached storage bytes.
+  size_t cached_bytes() const;
+
+  /// @brief The acquires served from the cache.
+  size_t hits() const;
+
+  /// @brief The acquires served with the new allocations.
+  size_t misses() const;
+
+  /// @brief The power of two size class able to hold the given capacity.
+  static size_t size_class(const size_t& capacity);
+
+  /// @brief The pool acquire or the plain allocation without a pool.
+  static barchdata acquire_from(const BufferPoolPtr& pool,
+                                const size_t& capacity);
+
+  /// @brief The pool release or the plain free without a pool.
+  static void release_to(const BufferPoolPtr& pool, barchdata&& buffer);
+
+  static BufferPoolPtr create(const size_t& maxBytes = default_max_bytes);
+
+  inline static constexpr const size_t default_max_bytes = 256U << 20U;
+  inline static constexpr const size_t min_class = 64U;
+
+ private:
+  const size_t mmaxbytes;
+
+  mutable std::mutex mm;
+  // The size class to the free buffers of at least that capacity
+  std::map<size_t, std::vector<barchdata>> mfree;
+  size_t mbytes{0U};
+
+  std::atomic<size_t> mhits{0U};
+  std::atomic<size_t> mmisses{0U};
+};
+
+using BufferPoolPtr = BufferPool::BufferPoolPtr;
+
+}  // namespace barchclib0::memory
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BUFFERPOOL_CLASS_H
@@ -0,0 +1,135 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/lib/libmain/memory/BufferPool.h"
+
+using namespace barchclib0;
+using namespace barchclib0::memory;
+using namespace testing;
+
+class UTEST_BufferPool : public Test
+{
+ public:
+  static constexpr const size_t rowSize = 825U;
+  static constexpr const size_t rowClass = 1024U;
+  static constexpr const size_t rowsCount = 16U;
+
+  UTEST_BufferPool() : pool{BufferPool::create()}
+  {
+    EXPECT_NE(pool, nullptr);
+    EXPECT_EQ(pool->cached_bytes(), 0U);
+  }
+
+  BufferPoolPtr pool;
+};
+
+TEST_F(UTEST_BufferPool, size_classes)
+{
+  EXPECT_EQ(BufferPool::size_class(0U), BufferPool::min_class);
+  EXPECT_EQ(BufferPool::size_class(1U), BufferPool::min_class);
+  EXPECT_EQ(BufferPool::size_class(BufferPool::min_class),
+            BufferPool::min_class);
+  EXPECT_EQ(BufferPool::size_class(rowSize), rowClass);
+  EXPECT_EQ(BufferPool::size_class(rowClass + 1U), rowClass * 2U);
+}
+
+TEST_F(UTEST_BufferPool, acquire_empty_with_capacity)
+{
+  barchdata buffer = pool->acquire(rowSize);
+
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_GE(buffer.capacity(), rowSize);
+  EXPECT_EQ(pool->misses(), 1U);
+  EXPECT_EQ(pool->hits(), 0U);
+}
+
+TEST_F(UTEST_BufferPool, released_storage_reused)
+{
+  barchdata buffer = pool->acquire(rowSize);
+
+  buffer.assign(rowSize, 1U);
+
+  const unsigned char* const storage = buffer.data();
+
+  pool->release(std::move(buffer));
+
+  EXPECT_EQ(pool->cached_bytes(), rowClass);
+
+  barchdata reused = pool->acquire(rowSize - 1U);
+
+  EXPECT_TRUE(reused.empty());
+  EXPECT_EQ(reused.data(), storage);
+  EXPECT_EQ(pool->hits(), 1U);
+  EXPECT_EQ(pool->cached_bytes(), 0U);
+}
+
+TEST_F(UTEST_BufferPool, released_to_lower_class)
+{
+  barchdata buffer;
+
+  buffer.reserve(rowClass + rowClass / 2U);
+
+  pool->release(std::move(buffer));
+
+  barchdata reused = pool->acquire(rowSize);
+
+  EXPECT_EQ(pool->hits(), 1U);
+  EXPECT_GE(reused.capacity(), rowSize);
+
+  pool->release(barchdata(BufferPool::min_class / 2U, 0U));
+
+  EXPECT_EQ(pool->cached_bytes(), 0U);
+}
+
+TEST_F(UTEST_BufferPool, limit_and_clear)
+{
+  auto limited = BufferPool::create(rowClass);
+
+  limited->release(limited->acquire(rowSize));
+  limited->release(limited->acquire(rowSize));
+
+  EXPECT_EQ(limited->cached_bytes(), rowClass);
+
+  limited->clear();
+
+  EXPECT_EQ(limited->cached_bytes(), 0U);
+}
+
+TEST_F(UTEST_BufferPool, no_pool_plain_allocation)
+{
+  barchdata buffer = BufferPool::acquire_from(nullptr, rowSize);
+
+  EXPECT_GE(buffer.capacity(), rowSize);
+
+  BufferPool::release_to(nullptr, std::move(buffer));
+  BufferPool::release_to(pool, BufferPool::acquire_from(pool, rowSize));
+
+  EXPECT_EQ(pool->cached_bytes(), rowClass);
+}
+
+TEST_F(UTEST_BufferPool, concurrent_acquire_release)
+{
+  std::vector<std::thread> threads;
+
+  for (size_t titer = 0U; titer < 4U; ++titer) {
+    threads.emplace_back([this]() {
+      for (size_t iter = 0U; iter < rowsCount * rowsCount; ++iter) {
+        barchdata buffer = pool->acquire(rowSize);
+
+        buffer.assign(rowSize, 0U);
+        pool->release(std::move(buffer));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(pool->hits() + pool->misses(), 4U * rowsCount * rowsCount);
+  EXPECT_LE(pool->misses(), 4U);
+}
@@ -1,11 +1,13 @@
 #include "src/lib/libmain/readers/BMPReader.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <exception>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "src/lib/libmain/readers/BMP.h"
@@ -118,31 +120,41 @@ BMPImagePtr BMPReader::read_data(const fs::path& imagePath)
 
   LOGT("Expected size: " << expectedNumSize << " bytes");
 
-  barchdata fdata;
+  barchdata fdata = memory::BufferPool::acquire_from(mpool, expectedNumSize);
 
-  fdata.reserve(expectedNumSize);
+  fdata.resize(expectedNumSize);
 
   const size_t paddingCount = rowSize - static_cast<size_t>(width);
   std::streamsize readSize{0};
 
   LOGT("Padding " << paddingCount << " bytes");
 
+  barchdata buff =
+      memory::BufferPool::acquire_from(mpool, static_cast<size_t>(rowSize));
+
+  buff.resize(static_cast<size_t>(rowSize));
+
   for (size_t crow = 0U; crow < static_cast<size_t>(height); crow++) {
-    barchdata buff(rowSize, static_cast<unsigned char>(0));
+    std::fill(buff.begin(), buff.end(), static_cast<unsigned char>(0));
 
     fimage.read(reinterpret_cast<char*>(buff.data()), rowSize);
 
     readSize += fimage.gcount();
 
-    buff.resize(width);
+    // The bottom-up rows are placed straight at their top-down offset
+    const size_t drow = infoHeader.biHeight > 0
+                            ? static_cast<size_t>(height) - 1U - crow
+                            : crow;
 
-    if (infoHeader.biHeight > 0) {
-      fdata.insert(fdata.begin(), buff.begin(), buff.end());
-    } else {
-      fdata.insert(fdata.end(), buff.begin(), buff.end());
-    }
+    const auto dst =
+        fdata.begin() +
+        static_cast<std::ptrdiff_t>(drow * static_cast<size_t>(width));
+
+    std::copy(buff.cbegin(), buff.cbegin() + width, dst);
   }
 
+  memory::BufferPool::release_to(mpool, std::move(buff));
+
   fimage.close();
 
   if (fdata.size() != expectedNumSize) {
@@ -156,6 +168,7 @@ BMPImagePtr BMPReader::read_data(const fs::path& imagePath)
   LOGT("Filling image with " << width << "x" << height << " (" << fdata.size()
                              << " bytes) of data");
 
+  image->pool(mpool);
   image->data(std::move(fdata));
   image->bits_per_pixel(infoHeader.biBitCount);
 
@@ -1,13 +1,15 @@
 #include "src/lib/libmain/readers/BarchReader0.h"
 
-#include <bitset>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "src/lib/libmain/readers/BMP.h"
@@ -26,6 +28,12 @@ IBarchImagePtr BarchReader0::unified_read(const fs::path& imagePath)
   return read(imagePath);
 }
 
+void BarchReader0::pool(const memory::BufferPoolPtr& npool)
+{
+  IReader::pool(npool);
+  converters::BMPAndBarchConverter0Base::pool(npool);
+}
+
 bool BarchReader0::is_barch(const fs::path& imagePath)
 {
   static const std::string ebarch = ".barch";
@@ -64,7 +72,72 @@ BarchImagePtr BarchReader0::read(const fs::path& imagePath)
   return nullptr;
 }
 
-bool BarchReader0::check_file_starter(std::ifstream& f)
+BMPImagePtr BarchReader0::read_thumbnail(const fs::path& imagePath)
+{
+  try {
+    std::ifstream f{imagePath, std::ifstream::binary};
+
+    if (!f.is_open()) {
+      LOGE("Failure during file open: " << imagePath);
+      return {};
+    }
+
+    BarchFormat format{BarchFormat::ba000};
+    bool thumbnail = false;
+
+    if (!check_file_starter(f, format, thumbnail)) {
+      LOGE("Not valid file starter " << imagePath);
+      return {};
+    }
+
+    if (!thumbnail) {
+      LOGD("No thumbnail embedded into " << imagePath);
+      return {};
+    }
+
+    size_t width = 0U;
+    size_t height = 0U;
+
+    f.seekg(static_cast<std::streamoff>(thumbnail_offset));
+
+    if (!read_thumbnail_sides(f, width, height)) {
+      LOGE("Fail to read the thumbnail sides " << imagePath);
+      return {};
+    }
+
+    barchdata pixels = memory::BufferPool::acquire_from(mpool, width * height);
+
+    pixels.resize(width * height);
+
+    f.read(reinterpret_cast<char*>(pixels.data()),
+           static_cast<std::streamsize>(pixels.size()));
+
+    if (!static_cast<bool>(f)) {
+      LOGE("The thumbnail of " << imagePath << " is truncated");
+      memory::BufferPool::release_to(mpool, std::move(pixels));
+      return {};
+    }
+
+    auto bmp = BMPImage::create();
+
+    bmp->pool(mpool);
+    bmp->width(width);
+    bmp->height(height);
+    bmp->bits_per_pixel(get_supported_bits());
+    bmp->data(std::move(pixels));
+
+    return bmp;
+  }
+  catch (const std::exception& e) {
+    LOGE("Exception " << e.what() << " during file " << imagePath
+                      << " thumbnail read");
+  }
+
+  return {};
+}
+
+bool BarchReader0::check_file_starter(std::ifstream& f, BarchFormat& format,
+                                      bool& thumbnail)
 {
   assert(f.is_open());
 
@@ -77,7 +150,25 @@ bool BarchReader0::check_file_starter(std::ifstream& f)
     return false;
   }
 
-  if (starter != BARCH0_STARTER_STR) {
+  thumbnail = starter[thumbnail_mark_at] == thumbnail_mark;
+
+  if (thumbnail) {
+    starter[thumbnail_mark_at] = BARCH0_STARTER_STR[thumbnail_mark_at];
+  }
+
+  if (starter == BARCH0_STARTER_STR) {
+    format = BarchFormat::ba000;
+  } else if (starter == BARCH1_STARTER_STR) {
+    format = BarchFormat::ba001;
+  } else if (starter == BARCH2_STARTER_STR) {
+    format = BarchFormat::ba002;
+  } else if (starter == BARCH3_STARTER_STR) {
+    format = BarchFormat::ba003;
+  } else if (starter == BARCH4_STARTER_STR) {
+    format = BarchFormat::ba004;
+  } else if (starter == BARCH5_STARTER_STR) {
+    format = BarchFormat::ba005;
+  } else {
     LOGE("Encounter inappropriate barch file starter constant: " << starter);
     return false;
   }
@@ -115,6 +206,31 @@ bool BarchReader0::read_dimentions(BarchImagePtr image, std::ifstream& f)
   return true;
 }
 
+bool BarchReader0::read_thumbnail_sides(std::ifstream& f, size_t& width,
+                                        size_t& height)
+{
+  assert(f.is_open());
+
+  unsigned char sides[2U]{zero, zero};
+
+  f.read(reinterpret_cast<char*>(sides), sizeof(sides));
+
+  if (!static_cast<bool>(f)) {
+    LOGE("Failure with file");
+    return false;
+  }
+
+  width = sides[0U];
+  height = sides[1U];
+
+  if (width == 0U || height == 0U) {
+    LOGE("Invalid thumbnail size " << width << "x" << height);
+    return false;
+  }
+
+  return true;
+}
+
 BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
 {
   std::ifstream f{imagePath, std::ifstream::binary};
@@ -124,7 +240,10 @@ BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
     return {};
   }
 
-  if (!check_file_starter(f)) {
+  BarchFormat format{BarchFormat::ba000};
+  bool thumbnail = false;
+
+  if (!check_file_starter(f, format, thumbnail)) {
     LOGE("Not valid file starter " << imagePath);
     return {};
   }
@@ -133,11 +252,32 @@ BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
 
   assert(image != nullptr);
 
+  image->pool(mpool);
+  image->format(format);
+
   if (!read_dimentions(image, f)) {
     LOGE("Fail to read file dimentions " << imagePath);
     return {};
   }
 
+  // The preview is for the read_thumbnail, the rows don't need it
+  if (thumbnail) {
+    size_t twidth = 0U;
+    size_t theight = 0U;
+
+    if (!read_thumbnail_sides(f, twidth, theight)) {
+      LOGE("Fail to skip the thumbnail " << imagePath);
+      return {};
+    }
+
+    f.seekg(static_cast<std::streamoff>(twidth * theight), std::ios::cur);
+  }
+
+  if (entropy_coded(format) && !read_entropy_lengths(image, f)) {
+    LOGE("Fail to read the code lengths table " << imagePath);
+    return {};
+  }
+
   if (!read_lines_table(image, f)) {
     LOGE("Fail to read lines table from the file " << imagePath);
     return {};
@@ -145,7 +285,9 @@ BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
 
   const size_t maxSize = image->width() * image->height();
 
-  barchdata filed(maxSize, static_cast<unsigned char>(0));
+  barchdata filed = memory::BufferPool::acquire_from(mpool, maxSize);
+
+  filed.resize(maxSize);
 
   f.read(reinterpret_cast<char*>(filed.data()), filed.size());
 
@@ -153,11 +295,15 @@ BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
 
   LOGT("Read " << bytesRead << " bytes from " << maxSize << " max expected");
 
-  filed.erase(filed.begin() + bytesRead, filed.end());
+  filed.resize(bytesRead);
 
   f.close();
 
-  if (!split_lines(image, filed)) {
+  const bool split = split_lines(image, filed);
+
+  memory::BufferPool::release_to(mpool, std::move(filed));
+
+  if (!split) {
     LOGE("Fail to split lines");
     return {};
   }
@@ -165,20 +311,45 @@ BarchImagePtr BarchReader0::read_data(const fs::path& imagePath)
   return image;
 }
 
-bool BarchReader0::split_lines(BarchImagePtr barch, barchdata& idata)
+bool BarchReader0::split_lines(BarchImagePtr barch, const barchdata& idata)
 {
   assert(barch != nullptr);
 
-  if (idata.empty()) {
+  if (idata.empty() && !barch->has_fills() && !barch->has_refs()) {
     LOGE("Empty data provided");
     return false;
   }
 
   const auto lt = barch->lines_table();
 
-  for (size_t lti = 0U; lti < lt.size() && !idata.empty(); ++lti) {
+  converters::PixelHuffman0 huffman;
+  const bool entropy = entropy_coded(barch->format());
+
+  if (entropy && !huffman.assign(barch->entropy_lengths().data(),
+                                 barch->entropy_lengths().size())) {
+    LOGE("Invalid code lengths table");
+    return false;
+  }
+
+  const converters::PixelHuffman0* table = entropy ? &huffman : nullptr;
+
+  // The rows are cut by the moving cursor, not erased from the front
+  auto cursor = idata.cbegin();
+
+  for (size_t lti = 0U; lti < lt.size(); ++lti) {
+    // The uniform and the repeated rows carry no payload
+    if (!barch->has_payload(lti)) {
+      barch->height(barch->height() - 1U);
+      barch->append_line(barchdata{});
+      continue;
+    }
+
+    if (cursor >= idata.cend()) {
+      break;
+    }
+
     if (lt[lti]) {
-      if (!extract_compressed_line(barch, idata)) {
+      if (!extract_compressed_line(barch, cursor, idata.cend(), table)) {
         LOGE("Fail to extract the compressed line");
         return false;
       }
@@ -186,98 +357,81 @@ bool BarchReader0::split_lines(BarchImagePtr barch, barchdata& idata)
       continue;
     }
 
-    auto idb = idata.begin();
-    auto ide = idata.begin() + barch->width();
+    const auto ide =
+        cursor + std::min(std::distance(cursor, idata.cend()),
+                          static_cast<std::ptrdiff_t>(barch->width()));
 
-    barchdata scanline(idb, ide);
+    barchdata scanline =
+        memory::BufferPool::acquire_from(mpool, barch->width());
 
-    idata.erase(idb, ide);
+    scanline.assign(cursor, ide);
+    cursor = ide;
 
     barch->height(barch->height() - 1U);
-    barch->append_line(scanline);
+    barch->append_line(std::move(scanline));
   }
 
   return true;
 }
 
-bool BarchReader0::extract_compressed_line(BarchImagePtr barch,
-                                           barchdata& idata)
+bool BarchReader0::extract_compressed_line(
+    BarchImagePtr barch, barchdata::const_iterator& cursor,
+    barchdata::const_iterator end, const converters::PixelHuffman0* table)
 {
-  static_assert(leftbit == 0B10000000);
-
   LOGT("Trying to extract the compressed line with " << barch->width()
                                                      << " max width");
 
-  size_t line_size{zero};
-  auto biter = idata.cbegin();
+  const auto left = static_cast<size_t>(std::distance(cursor, end));
+  const size_t size =
+      long_runs(barch->format())
+          ? codec_kernel_runs::encoded_row_size(&*cursor, left, barch->width(),
+                                                table)
+          : codec_kernel::encoded_row_size(&*cursor, left, barch->width());
 
-  while (biter < idata.cend() && line_size < barch->width()) {
-    unsigned char cc = *biter;
-    unsigned char ccleft = ucharbits;
+  const auto biter = cursor + static_cast<std::ptrdiff_t>(size);
 
-    LOGT("Taking next byte " << std::bitset<8>(cc) << " and line size is "
-                             << line_size);
+  barchdata line = memory::BufferPool::acquire_from(
+      mpool, static_cast<size_t>(std::distance(cursor, biter)));
 
-    while (ccleft > 0 && line_size < barch->width() && biter < idata.end()) {
-      const int ictype = get_next_pack_type(biter, idata.cend(), cc, ccleft);
+  line.assign(cursor, biter);
+  cursor = biter;
 
-      if (ictype < 0) {
-        LOGT("End of data reached");
-        break;
-      }
+  barch->height(barch->height() - 1U);
+  barch->append_line(std::move(line));
 
-      const unsigned char ctype = static_cast<unsigned char>(ictype);
-
-      if (ctype == coded_whites) {
-        // 4 whites
-        LOGT("Located " << get_batch_pixels_compress()
-                        << " white bytes encoded");
-        line_size += get_batch_pixels_compress();
-      } else if (ctype == coded_blacks) {
-        // 4 blacks
-        LOGT("Located " << get_batch_pixels_compress()
-                        << " black bytes encoded");
-        line_size += get_batch_pixels_compress();
-      } else if (ctype == coded_as_is) {
-        LOGT("Located grays " << get_batch_pixels_compress()
-                              << " bytes encoded");
-        // 4 grays
-        line_size += get_batch_pixels_compress();
-        // skip all other bits
-        unsigned int skips{0U};
-        while (skips++ < get_batch_pixels_compress() && biter < idata.end()) {
-          biter++;
-        }
-        if (biter >= idata.end()) {
-          break;
-        }
-        cc = *biter;
-        cc <<= ucharbits - ccleft;
-      } else {
-        LOGE("Unknown compression type: " << static_cast<unsigned int>(ctype));
-        return false;
-      }
-    }
+  return true;
+}
 
-    ++biter;
-  }
+bool BarchReader0::read_entropy_lengths(BarchImagePtr barch, std::ifstream& f)
+{
+  barchdata lengths(converters::PixelHuffman0::symbols, zero);
+
+  f.read(reinterpret_cast<char*>(lengths.data()),
+         static_cast<std::streamsize>(lengths.size()));
 
-  if (biter >= idata.end()) {
-    biter = idata.end();
+  if (!static_cast<bool>(f)) {
+    LOGE("Failure with file");
+    return false;
   }
 
-  barchdata line(idata.cbegin(), biter);
-  idata.erase(idata.cbegin(), biter);
+  if (!converters::PixelHuffman0{}.assign(lengths.data(), lengths.size())) {
+    LOGE("The code lengths make no prefix code");
+    return false;
+  }
 
-  barch->height(barch->height() - 1U);
-  barch->append_line(line);
+  barch->entropy_lengths(lengths);
 
   return true;
 }
 
 bool BarchReader0::read_lines_table(BarchImagePtr barch, std::ifstream& f)
 {
-  size_t ltbytes = std::ceil(barch->height() / 8.0);
+  const bool fills = row_fills(barch->format());
+  const bool refs = row_refs(barch->format());
+  const bool predicts = row_predicts(barch->format());
+  const unsigned int code_bits = table_code_bits(barch->format());
+  const size_t ltbytes =
+      (barch->height() * code_bits + ucharbits - 1U) / ucharbits;
 
   if (ltbytes == 0U) {
     LOGE("Invalid lines table value computed");
@@ -294,18 +448,69 @@ bool BarchReader0::read_lines_table(BarchImagePtr barch, std::ifstream& f)
   }
 
   linestable unpacklt;
+  fillstable unpackft;
+  refstable unpackrt;
+  predictedtable unpackpt;
 
   unpacklt.reserve(barch->height());
 
   for (unsigned char fltb : filelt) {
     for (unsigned int iter = 0U;
-         iter < ucharbits && unpacklt.size() < barch->height(); ++iter) {
-      unpacklt.emplace_back(static_cast<bool>(fltb & leftmostone));
-      fltb <<= 1;
+         iter < ucharbits && unpacklt.size() < barch->height();
+         iter += code_bits) {
+      const unsigned int code = static_cast<unsigned int>(fltb) >>
+                                (ucharbits - code_bits);
+
+      fltb = static_cast<unsigned char>(fltb << code_bits);
+
+      const size_t row = unpacklt.size();
+      const bool predicted = predicts && code == row_predicted;
+
+      if (code > row_blacks && code < row_reference && !predicted) {
+        LOGE("Unknown rows table code " << code << " of the row " << row);
+        return false;
+      }
+
+      if (predicted && row == 0U) {
+        LOGE("The first row can't be predicted");
+        return false;
+      }
+
+      unpacklt.emplace_back(code != row_raw);
+
+      if (predicts) {
+        unpackpt.emplace_back(predicted);
+      }
+
+      if (refs) {
+        const size_t ref =
+            (code & row_reference) != 0U ? (code & row_ref_mask) + 1U : 0U;
+
+        if (ref > row) {
+          LOGE("The row " << row << " refers above the image");
+          return false;
+        }
+
+        unpackrt.emplace_back(ref);
+
+        if (ref != 0U) {
+          unpackft.emplace_back(RowFill::none);
+          continue;
+        }
+      }
+
+      if (fills) {
+        unpackft.emplace_back(code == row_whites   ? RowFill::whites
+                              : code == row_blacks ? RowFill::blacks
+                                                   : RowFill::none);
+      }
     }
   }
 
   barch->lines_table(std::move(unpacklt));
+  barch->fills_table(std::move(unpackft));
+  barch->refs_table(std::move(unpackrt));
+  barch->predicted_table(std::move(unpackpt));
 
   return static_cast<bool>(f);
 }
@@ -41,19 +41,49 @@ class BarchReader0 : public std::enable_shared_from_this<BarchReader0>,
 
   virtual IBarchImagePtr unified_read(const fs::path& imagePath) override;
 
+  /**
+   * @brief Reads only the embedded preview of the file: the few bytes at the
+   * thumbnail_offset, no rows are read nor decoded.
+   *
+   * @returns The preview as the grayscale BMPImage or a nullptr value for
+   * the files without the thumbnail section and in case of any error.
+   */
+  virtual BMPImagePtr read_thumbnail(const fs::path& imagePath);
+
   static bool is_barch(const fs::path& imagePath);
 
+  /// @brief The pool for the read image buffers, none by default
+  virtual void pool(const memory::BufferPoolPtr& npool) override;
+
+ protected:
+  using IReader::mpool;
+
  private:
   BarchImagePtr read_data(const fs::path& imagePath);
 
-  bool check_file_starter(std::ifstream& f);
+  /**
+   * @brief Checks the starter and gives the format variant it stands for and
+   * whether the thumbnail section follows the dimensions
+   */
+  bool check_file_starter(std::ifstream& f, BarchFormat& format,
+                          bool& thumbnail);
   bool read_dimentions(BarchImagePtr image, std::ifstream& f);
+  /// @brief Reads the thumbnail section sides, the pixels follow them
+  bool read_thumbnail_sides(std::ifstream& f, size_t& width, size_t& height);
+  bool read_entropy_lengths(BarchImagePtr barch, std::ifstream& f);
   bool read_lines_table(BarchImagePtr barch, std::ifstream& f);
-  bool split_lines(BarchImagePtr barch, barchdata& idata);
-  bool extract_compressed_line(BarchImagePtr barch, barchdata& idata);
+  bool split_lines(BarchImagePtr barch, const barchdata& idata);
+  bool extract_compressed_line(BarchImagePtr barch,
+                               barchdata::const_iterator& cursor,
+                               barchdata::const_iterator end,
+                               const converters::PixelHuffman0* table);
 
-  inline static constexpr const unsigned char leftmostone = 0B10000000;
   inline static const std::string BARCH0_STARTER_STR = BARCH0_STARTER;
+  inline static const std::string BARCH1_STARTER_STR = BARCH1_STARTER;
+  inline static const std::string BARCH2_STARTER_STR = BARCH2_STARTER;
+  inline static const std::string BARCH3_STARTER_STR = BARCH3_STARTER;
+  inline static const std::string BARCH4_STARTER_STR = BARCH4_STARTER;
+  inline static const std::string BARCH5_STARTER_STR = BARCH5_STARTER;
 
   unsigned char get_compress_type(barchdata::iterator& liter,
                                   barchdata::iterator& lend, unsigned char& cc,
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "IBarchImage.h"
+#include "src/lib/libmain/memory/BufferPool.h"
 
 namespace barchclib0::readers
 {
@@ -29,6 +30,12 @@ class IReader
    * nullptr value in case of any error.
    */
   virtual IBarchImagePtr unified_read(const fs::path& imagePath) = 0;
+
+  /// @brief The pool for the read image buffers, none by default
+  virtual void pool(const memory::BufferPoolPtr& npool) { mpool = npool; }
+
+ protected:
+  memory::BufferPoolPtr mpool;
 };
 
 using IReaderPtr = IReader::IReaderPtr;
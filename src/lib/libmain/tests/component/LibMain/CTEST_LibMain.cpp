@@ -1,8 +1,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "LibMain_includes.h"
 #include "LibraryContext.h"
@@ -35,6 +43,69 @@ class CTEST_LibMain : public Test
     EXPECT_NE(controller, nullptr);
   }
 
+  /// @brief Encodes the width x height pixels in the format
+  IBarchImagePtr encode(const BarchFormat& format, const size_t& width,
+                        const size_t& height, const barchdata& pixels)
+  {
+    auto bmp = controller->create_empty_bmp();
+
+    bmp->width(width);
+    bmp->height(height);
+    bmp->data(pixels);
+
+    controller->barch_format(format);
+
+    return controller->bmp_to_barch(bmp);
+  }
+
+  /**
+   * @brief Encodes the pixels in the format, writes the file, reads it back
+   * and checks the format and the restored pixels. Returns the read image
+   * for the format specific checks, nullptr on the failure.
+   */
+  std::shared_ptr<BarchImage> roundtrip_file(const BarchFormat& format,
+                                             const size_t& width,
+                                             const size_t& height,
+                                             const barchdata& pixels)
+  {
+    IBarchImagePtr barch = encode(format, width, height, pixels);
+
+    if (barch == nullptr) {
+      ADD_FAILURE() << "Fail to encode the pixels";
+      return nullptr;
+    }
+
+    const auto path = testbarchdir / ("test-ba00" +
+                                      std::to_string(static_cast<int>(format)) +
+                                      ".barch");
+
+    barch->filepath(path);
+
+    EXPECT_TRUE(controller->write(barch));
+
+    auto read = std::dynamic_pointer_cast<BarchImage>(controller->read(path));
+
+    if (read == nullptr) {
+      ADD_FAILURE() << "Fail to read " << path;
+      return nullptr;
+    }
+
+    EXPECT_EQ(read->format(), format);
+    EXPECT_EQ(read->width(), width);
+    EXPECT_EQ(read->height(), height);
+
+    IBarchImagePtr restored = controller->barch_to_bmp(read);
+
+    if (restored == nullptr) {
+      ADD_FAILURE() << "Fail to restore " << path;
+      return nullptr;
+    }
+
+    EXPECT_EQ(restored->data(), pixels);
+
+    return read;
+  }
+
   LibMainPtr controller;
 };
 
@@ -306,3 +377,586 @@ TEST_F(CTEST_LibMain, restore_bmp_1_from_file_success)
     }
   }
 }
+
+TEST_F(CTEST_LibMain, read_async_future_success)
+{
+  auto bmp1 = controller->read_async(i1);
+  auto missing = controller->read_async(images_root / "missing.bmp");
+
+  IBarchImagePtr image = bmp1.get();
+
+  ASSERT_NE(image, nullptr);
+  EXPECT_EQ(image->width(), 825U);
+  EXPECT_EQ(image->height(), 1200U);
+  EXPECT_EQ(missing.get(), nullptr);
+}
+
+TEST_F(CTEST_LibMain, async_callbacks_chain_success)
+{
+  static constexpr const std::chrono::seconds waitLimit{300};
+
+  const std::filesystem::path barchpath = testbarchdir / "async.barch";
+  std::promise<bool> written;
+  auto writtenFuture = written.get_future();
+  LibMainPtr lib = controller;
+
+  controller->executor_threads(2U);
+
+  controller->read_async(i2, [lib, barchpath, &written](IBarchImagePtr bmp) {
+    if (bmp == nullptr) {
+      written.set_value(false);
+      return;
+    }
+
+    lib->bmp_to_barch_async(
+        bmp, [lib, barchpath, &written](IBarchImagePtr barch) {
+          if (barch == nullptr) {
+            written.set_value(false);
+            return;
+          }
+
+          barch->filepath(barchpath);
+          lib->write_async(barch,
+                           [&written](bool ok) { written.set_value(ok); });
+        });
+  });
+
+  ASSERT_EQ(writtenFuture.wait_for(waitLimit), std::future_status::ready);
+  ASSERT_TRUE(writtenFuture.get());
+
+  IBarchImagePtr barch = controller->read_async(barchpath).get();
+
+  ASSERT_NE(barch, nullptr);
+
+  IBarchImagePtr restored = controller->barch_to_bmp_async(barch).get();
+  IBarchImagePtr original = controller->read(i2);
+
+  ASSERT_NE(restored, nullptr);
+  ASSERT_NE(original, nullptr);
+  EXPECT_EQ(restored->data(), original->data());
+}
+
+TEST_F(CTEST_LibMain, buffer_pool_reused_across_files)
+{
+  ASSERT_NE(controller->buffer_pool(), nullptr);
+
+  for (const auto& path : {i1, i2}) {
+    IBarchImagePtr bmp = controller->read(path);
+
+    ASSERT_NE(bmp, nullptr);
+    ASSERT_NE(controller->bmp_to_barch(bmp), nullptr);
+  }
+
+  EXPECT_GT(controller->buffer_pool()->hits(), 0U);
+  EXPECT_GT(controller->buffer_pool()->cached_bytes(), 0U);
+}
+
+TEST_F(CTEST_LibMain, shared_codecs_concurrent_roundtrip_success)
+{
+  static constexpr const size_t threads = 4U;
+
+  IBarchImagePtr reference = controller->read(i1);
+
+  ASSERT_NE(reference, nullptr);
+
+  const barchdata expected = reference->data();
+  std::vector<bool> matches(threads, false);
+  std::vector<std::thread> workers;
+
+  for (size_t index = 0U; index < threads; ++index) {
+    workers.emplace_back([this, &expected, &matches, index]() {
+      IBarchImagePtr bmp = controller->read(i1);
+      IBarchImagePtr barch =
+          bmp != nullptr ? controller->bmp_to_barch(bmp) : nullptr;
+      IBarchImagePtr restored =
+          barch != nullptr ? controller->barch_to_bmp(barch) : nullptr;
+
+      matches[index] = restored != nullptr && restored->data() == expected;
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (size_t index = 0U; index < threads; ++index) {
+    EXPECT_TRUE(matches[index]) << "Thread " << index;
+  }
+}
+
+TEST_F(CTEST_LibMain, ba001_file_roundtrip_success)
+{
+  IBarchImagePtr bmp = controller->read(i1);
+
+  ASSERT_NE(bmp, nullptr);
+
+  IBarchImagePtr ba000 = controller->bmp_to_barch(bmp);
+
+  controller->barch_format(BarchFormat::ba001);
+
+  IBarchImagePtr ba001 = controller->bmp_to_barch(bmp);
+
+  ASSERT_NE(ba000, nullptr);
+  ASSERT_NE(ba001, nullptr);
+  EXPECT_LE(ba001->data().size(), ba000->data().size());
+
+  const auto ba001path = testbarchdir / "test-ba001.barch";
+
+  ba001->filepath(ba001path);
+
+  ASSERT_TRUE(controller->write(ba001));
+
+  auto read = std::dynamic_pointer_cast<BarchImage>(controller->read(ba001path));
+
+  ASSERT_NE(read, nullptr);
+  EXPECT_EQ(read->format(), BarchFormat::ba001);
+  EXPECT_EQ(read->data(), ba001->data());
+
+  IBarchImagePtr restored = controller->barch_to_bmp(read);
+
+  ASSERT_NE(restored, nullptr);
+  EXPECT_EQ(restored->data(), bmp->data());
+}
+
+TEST_F(CTEST_LibMain, ba002_blank_rows_file_roundtrip_success)
+{
+  static constexpr const size_t width = 37U;
+  static constexpr const size_t height = 11U;
+
+  // The whites, blacks and the mixed rows; the all whites image has no
+  // payload at all
+  barchdata mixed(width * height, 255U);
+
+  for (size_t row = 0U; row < height; row += 3U) {
+    std::fill_n(mixed.begin() + static_cast<std::ptrdiff_t>(row * width),
+                width, 0U);
+  }
+
+  mixed[width * 2U + 5U] = 100U;
+
+  for (const auto& pixels : {mixed, barchdata(width * height, 255U)}) {
+    auto read = roundtrip_file(BarchFormat::ba002, width, height, pixels);
+
+    ASSERT_NE(read, nullptr);
+    EXPECT_TRUE(read->has_fills());
+  }
+}
+
+TEST_F(CTEST_LibMain, ba003_repeated_rows_file_roundtrip_success)
+{
+  static constexpr const size_t width = 301U;
+  static constexpr const size_t height = 200U;
+
+  // Every row of the ruled page repeats one of the 5 rows above it
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    for (size_t col = row % 5U; col < width; col += 7U) {
+      pixels[row * width + col] = static_cast<unsigned char>(col % 5U);
+    }
+  }
+
+  IBarchImagePtr ba002 = encode(BarchFormat::ba002, width, height, pixels);
+
+  ASSERT_NE(ba002, nullptr);
+
+  auto read = roundtrip_file(BarchFormat::ba003, width, height, pixels);
+
+  ASSERT_NE(read, nullptr);
+  EXPECT_LT(read->data().size(), ba002->data().size());
+  EXPECT_TRUE(read->has_refs());
+}
+
+TEST_F(CTEST_LibMain, ba004_line_art_file_roundtrip_success)
+{
+  static constexpr const size_t width = 401U;
+  static constexpr const size_t height = 300U;
+
+  // The slanted wide strokes over the scanned gray paper texture: every
+  // row is the row above with the stroke edges moved by a pixel
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    for (size_t stroke = 0U; stroke < width; stroke += 40U) {
+      for (size_t pix = 0U; pix < 24U; ++pix) {
+        const size_t col = (stroke + row + pix) % width;
+
+        pixels[row * width + col] = static_cast<unsigned char>(60U + col % 50U);
+      }
+    }
+  }
+
+  IBarchImagePtr ba003 = encode(BarchFormat::ba003, width, height, pixels);
+
+  ASSERT_NE(ba003, nullptr);
+
+  auto read = roundtrip_file(BarchFormat::ba004, width, height, pixels);
+
+  ASSERT_NE(read, nullptr);
+  EXPECT_LT(read->data().size() * 2U, ba003->data().size());
+  EXPECT_TRUE(read->has_predicted());
+}
+
+TEST_F(CTEST_LibMain, ba005_photo_file_roundtrip_success)
+{
+  static constexpr const size_t width = 333U;
+  static constexpr const size_t height = 200U;
+
+  // The smooth gray gradient with the light noise: all groups are as-is and
+  // the pixels take a narrow range of values
+  barchdata pixels(width * height);
+
+  for (size_t row = 0U; row < height; ++row) {
+    for (size_t col = 0U; col < width; ++col) {
+      const size_t noise = ((row * width + col) * 2654435761U >> 13U) % 5U;
+
+      pixels[row * width + col] =
+          static_cast<unsigned char>(90U + col / 40U + row / 50U + noise);
+    }
+  }
+
+  IBarchImagePtr ba004 = encode(BarchFormat::ba004, width, height, pixels);
+
+  ASSERT_NE(ba004, nullptr);
+
+  auto read = roundtrip_file(BarchFormat::ba005, width, height, pixels);
+
+  ASSERT_NE(read, nullptr);
+  EXPECT_LT(read->data().size() * 3U, ba004->data().size() * 2U);
+  EXPECT_EQ(read->entropy_lengths().size(), 256U);
+}
+
+TEST_F(CTEST_LibMain, parallel_decode_same_pixels_success)
+{
+  static constexpr const size_t width = 1001U;
+  static constexpr const size_t height = 1500U;
+
+  // The document rows of every kind: uniform, repeated, predicted and raw
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    unsigned char* const dst = pixels.data() + row * width;
+
+    if (row % 7U == 0U) {
+      std::fill_n(dst, width, 0U);
+    } else if (row % 5U == 0U) {
+      for (size_t col = 0U; col < width; ++col) {
+        dst[col] = static_cast<unsigned char>((row * 31U + col * 17U) % 251U);
+      }
+    } else {
+      std::fill_n(dst + (row * 3U) % (width - 40U), 40U, 0U);
+    }
+  }
+
+  auto image = controller->create_empty_bmp();
+
+  image->width(width);
+  image->height(height);
+  image->data(pixels);
+
+  controller->barch_format(BarchFormat::ba004);
+
+  IBarchImagePtr barch = controller->bmp_to_barch(image);
+
+  ASSERT_NE(barch, nullptr);
+
+  IBarchImagePtr serial = controller->barch_to_bmp(barch);
+
+  controller->decode_threads(4U);
+
+  IBarchImagePtr parallel = controller->barch_to_bmp(barch);
+
+  controller->decode_threads(0U);
+
+  IBarchImagePtr hardware = controller->barch_to_bmp(barch);
+
+  ASSERT_NE(serial, nullptr);
+  ASSERT_NE(parallel, nullptr);
+  ASSERT_NE(hardware, nullptr);
+  EXPECT_EQ(serial->data(), pixels);
+  EXPECT_EQ(parallel->data(), pixels);
+  EXPECT_EQ(hardware->data(), pixels);
+}
+
+TEST_F(CTEST_LibMain, region_decode_matches_full_decode_success)
+{
+  static constexpr const size_t width = 203U;
+  static constexpr const size_t height = 120U;
+
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    unsigned char* const dst = pixels.data() + row * width;
+
+    if (row % 9U == 0U) {
+      std::fill_n(dst, width, 0U);
+    } else if (row % 4U == 0U) {
+      for (size_t col = 0U; col < width; ++col) {
+        dst[col] = static_cast<unsigned char>((row * 31U + col * 17U) % 251U);
+      }
+    } else {
+      std::fill_n(dst + (row * 3U) % (width - 30U), 30U, 60U);
+    }
+  }
+
+  auto image = controller->create_empty_bmp();
+
+  image->width(width);
+  image->height(height);
+  image->data(pixels);
+
+  for (const auto format : {BarchFormat::ba000, BarchFormat::ba004,
+                            BarchFormat::ba005}) {
+    controller->barch_format(format);
+
+    IBarchImagePtr barch = controller->bmp_to_barch(image);
+
+    ASSERT_NE(barch, nullptr);
+
+    for (const DecodeRegion region :
+         {DecodeRegion{0U, 0U, 0U, 0U}, DecodeRegion{37U, 20U, 0U, 0U},
+          DecodeRegion{50U, 1U, 13U, 70U}, DecodeRegion{1U, 119U, 199U, 4U},
+          DecodeRegion{77U, 43U, 5U, 0U}}) {
+      const size_t rows = region.rows == 0U ? height - region.row : region.rows;
+      const size_t cols = region.cols == 0U ? width - region.col : region.cols;
+      const size_t stride = cols + 3U;
+
+      barchdata buffer(stride * rows, 7U);
+
+      ASSERT_TRUE(controller->barch_to_buffer(
+          barch, DecodeTarget{buffer.data(), buffer.size(), stride}, region));
+
+      for (size_t row = 0U; row < rows; ++row) {
+        const size_t offset = (region.row + row) * width + region.col;
+        const auto src =
+            pixels.cbegin() + static_cast<std::ptrdiff_t>(offset);
+        const auto dst =
+            buffer.cbegin() + static_cast<std::ptrdiff_t>(row * stride);
+
+        EXPECT_TRUE(
+            std::equal(src, src + static_cast<std::ptrdiff_t>(cols), dst))
+            << "Row " << region.row + row << " column " << region.col;
+      }
+    }
+
+    barchdata buffer(width * height);
+
+    EXPECT_FALSE(controller->barch_to_buffer(
+        barch, DecodeTarget{buffer.data(), buffer.size(), width},
+        DecodeRegion{100U, 21U, 0U, 0U}));
+    EXPECT_FALSE(controller->barch_to_buffer(
+        barch, DecodeTarget{buffer.data(), buffer.size(), width},
+        DecodeRegion{0U, 0U, 200U, 4U}));
+  }
+}
+
+TEST_F(CTEST_LibMain, thumbnail_samples_full_decode_success)
+{
+  static constexpr const size_t width = 203U;
+  static constexpr const size_t height = 121U;
+
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    unsigned char* const dst = pixels.data() + row * width;
+
+    if (row % 9U == 0U) {
+      std::fill_n(dst, width, 0U);
+    } else if (row % 4U == 0U) {
+      for (size_t col = 0U; col < width; ++col) {
+        dst[col] = static_cast<unsigned char>((row * 31U + col * 17U) % 251U);
+      }
+    } else if (row % 11U != 0U) {
+      std::fill_n(dst + (row * 3U) % (width - 30U), 30U, 60U);
+    }
+  }
+
+  auto image = controller->create_empty_bmp();
+
+  image->width(width);
+  image->height(height);
+  image->data(pixels);
+
+  for (const auto format : {BarchFormat::ba000, BarchFormat::ba003,
+                            BarchFormat::ba004, BarchFormat::ba005}) {
+    controller->barch_format(format);
+
+    IBarchImagePtr barch = controller->bmp_to_barch(image);
+
+    ASSERT_NE(barch, nullptr);
+
+    for (const size_t scale : {2U, 4U, 8U}) {
+      IBarchImagePtr thumb = controller->barch_to_thumbnail(barch, scale);
+
+      ASSERT_NE(thumb, nullptr);
+      ASSERT_EQ(thumb->width(), (width + scale - 1U) / scale);
+      ASSERT_EQ(thumb->height(), (height + scale - 1U) / scale);
+
+      barchdata expected;
+
+      for (size_t row = 0U; row < height; row += scale) {
+        for (size_t col = 0U; col < width; col += scale) {
+          expected.push_back(pixels[row * width + col]);
+        }
+      }
+
+      EXPECT_EQ(thumb->data(), expected) << "Scale 1/" << scale;
+    }
+
+    EXPECT_EQ(controller->barch_to_thumbnail(barch, 3U), nullptr);
+  }
+}
+
+TEST_F(CTEST_LibMain, embedded_thumbnail_roundtrip_success)
+{
+  static constexpr const size_t width = 203U;
+  static constexpr const size_t height = 120U;
+  static constexpr const size_t scale = 13U;
+
+  barchdata pixels(width * height, 255U);
+
+  for (size_t row = 0U; row < height; ++row) {
+    for (size_t col = 0U; col < width; ++col) {
+      if ((row / 20U + col / 40U) % 2U == 0U) {
+        pixels[row * width + col] = static_cast<unsigned char>(col);
+      }
+    }
+  }
+
+  auto image = controller->create_empty_bmp();
+
+  image->width(width);
+  image->height(height);
+  image->data(pixels);
+
+  controller->barch_format(BarchFormat::ba004);
+  controller->thumbnail_side(16U);
+
+  IBarchImagePtr barch = controller->bmp_to_barch(image);
+
+  ASSERT_NE(barch, nullptr);
+
+  barch->filepath(testbarch);
+
+  ASSERT_TRUE(controller->write(barch));
+
+  IBarchImagePtr thumb = controller->read_thumbnail(testbarch);
+
+  ASSERT_NE(thumb, nullptr);
+  ASSERT_EQ(thumb->width(), 16U);
+  ASSERT_EQ(thumb->height(), 10U);
+
+  // The last block is clipped by the image edges
+  for (const auto& [trow, tcol] : {std::pair<size_t, size_t>{0U, 0U},
+                                   {4U, 7U}, {9U, 15U}}) {
+    size_t sum = 0U;
+    size_t count = 0U;
+
+    for (size_t row = trow * scale; row < std::min(height, (trow + 1U) * scale);
+         ++row) {
+      for (size_t col = tcol * scale;
+           col < std::min(width, (tcol + 1U) * scale); ++col) {
+        sum += pixels[row * width + col];
+        ++count;
+      }
+    }
+
+    EXPECT_EQ(thumb->data()[trow * 16U + tcol], (sum + count / 2U) / count);
+  }
+
+  // The rows reading skips the section
+  IBarchImagePtr read = controller->read(testbarch);
+
+  ASSERT_NE(read, nullptr);
+
+  IBarchImagePtr decoded = controller->barch_to_bmp(read);
+
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_EQ(decoded->data(), pixels);
+
+  controller->thumbnail_side(0U);
+
+  barch = controller->bmp_to_barch(image);
+
+  ASSERT_NE(barch, nullptr);
+
+  barch->filepath(testbarch);
+
+  ASSERT_TRUE(controller->write(barch));
+  EXPECT_EQ(controller->read_thumbnail(testbarch), nullptr);
+  EXPECT_NE(controller->read(testbarch), nullptr);
+}
+
+TEST_F(CTEST_LibMain, async_callback_called_on_throw_success)
+{
+  static constexpr const std::chrono::seconds waitLimit{300};
+
+  // The multicolor images make the encoder throw
+  auto image = controller->create_empty_bmp();
+
+  image->width(4U);
+  image->height(4U);
+  image->bits_per_pixel(24U);
+  image->data(barchdata(4U * 4U * 3U, 127U));
+
+  std::promise<IBarchImagePtr> converted;
+  auto convertedFuture = converted.get_future();
+
+  controller->bmp_to_barch_async(image, [&converted](IBarchImagePtr barch) {
+    converted.set_value(barch);
+  });
+
+  ASSERT_EQ(convertedFuture.wait_for(waitLimit), std::future_status::ready);
+  EXPECT_EQ(convertedFuture.get(), nullptr);
+}
+
+TEST_F(CTEST_LibMain, settings_change_during_conversions_success)
+{
+  IBarchImagePtr original = controller->read(i2);
+
+  ASSERT_NE(original, nullptr);
+
+  std::atomic<bool> stop{false};
+
+  // The conversions in flight keep the settings they started with
+  std::thread toggler{[this, &stop]() {
+    for (size_t iter = 0U; !stop.load(); ++iter) {
+      controller->barch_format(iter % 2U == 0U ? BarchFormat::ba004
+                                               : BarchFormat::ba001);
+      controller->encoder_preset(iter % 3U == 0U ? EncoderPreset::fast
+                                                 : EncoderPreset::max_ratio);
+      controller->thumbnail_side(iter % 64U);
+    }
+  }};
+
+  std::vector<std::future<IBarchImagePtr>> encoded;
+
+  for (size_t iter = 0U; iter < 8U; ++iter) {
+    encoded.emplace_back(controller->bmp_to_barch_async(original));
+  }
+
+  for (size_t iter = 0U; iter < 8U; ++iter) {
+    IBarchImagePtr barch = controller->bmp_to_barch(original);
+
+    ASSERT_NE(barch, nullptr);
+
+    IBarchImagePtr restored = controller->barch_to_bmp(barch);
+
+    ASSERT_NE(restored, nullptr);
+    EXPECT_EQ(restored->data(), original->data());
+  }
+
+  for (auto& future : encoded) {
+    IBarchImagePtr barch = future.get();
+
+    ASSERT_NE(barch, nullptr);
+
+    IBarchImagePtr restored = controller->barch_to_bmp(barch);
+
+    ASSERT_NE(restored, nullptr);
+    EXPECT_EQ(restored->data(), original->data());
+  }
+
+  stop.store(true);
+  toggler.join();
+}
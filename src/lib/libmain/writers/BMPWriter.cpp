@@ -0,0 +1,157 @@
+#include "src/lib/libmain/writers/BMPWriter.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "IBarchImage.h"
+#include "src/lib/libmain/readers/BMP.h"
+#include "src/log/log.h"
+#include "src/log/trace.h"
+
+namespace barchclib0::writers
+{
+
+BMPWriterPtr BMPWriter::create() { return std::make_shared<BMPWriter>(); }
+
+bool BMPWriter::write(BMPImagePtr image)
+{
+  if (image == nullptr) {
+    LOGE("Invalid image pointer provided");
+    return false;
+  }
+
+  return write(image, image->filepath());
+}
+
+bool BMPWriter::write(BMPImagePtr image, const std::filesystem::path& dstpath)
+{
+  if (image == nullptr) {
+    LOGE("Invalid image pointer provided");
+    return false;
+  }
+
+  if (dstpath.empty()) {
+    LOGE("No dst file path provided for an image to save");
+    return false;
+  }
+
+  TRACE_SPAN_FILE("io", "BMPWriter::write", dstpath.string());
+
+  try {
+    LOGT("Trying to open file " << dstpath);
+    std::ofstream dstfile(dstpath,
+                          std::ofstream::binary | std::ofstream::trunc);
+
+    if (!dstfile.is_open()) {
+      LOGE("Failure to open file " << dstpath);
+      return false;
+    }
+
+    if (!write(image, dstfile)) {
+      LOGE("Fail to write image to the file");
+      dstfile.close();
+      return false;
+    }
+
+    dstfile.close();
+  }
+  catch (const std::exception& e) {
+    LOGE("Exception during file save: " << e.what() << " for a filepath "
+                                        << dstpath);
+    return false;
+  }
+
+  image->filepath(dstpath);
+
+  return true;
+}
+
+bool BMPWriter::write(BMPImagePtr image, std::ofstream& dst)
+{
+  using readers::BITMAPFILEHEADER;
+  using readers::BITMAPINFOHEADER;
+
+  const size_t width = image->width();
+  const size_t height = image->height();
+
+  if (width == 0U || height == 0U) {
+    LOGE("Image with invalid size provided " << width << "x" << height);
+    return false;
+  }
+
+  if (width > max_int32_t || height > max_int32_t) {
+    LOGE("Can`t express the image size " << width << "x" << height
+                                          << " with int32_t");
+    return false;
+  }
+
+  if (image->bits_per_pixel() != supported_bits) {
+    LOGE("No 8 bit images are supported");
+    return false;
+  }
+
+  const auto& idata = image->data();
+
+  if (idata.size() != width * height) {
+    LOGE("Image data size " << idata.size() << " mismatches the image size "
+                            << width << "x" << height);
+    return false;
+  }
+
+  const size_t rowSize = ((supported_bits * width + 31U) / 32U) * 4U;
+  const uint32_t offset = static_cast<uint32_t>(
+      sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER) + palette_size * 4U);
+
+  BITMAPFILEHEADER fileHeader{};
+  fileHeader.bfType = bmp_magic;
+  fileHeader.bfOffBits = offset;
+  fileHeader.bfSize = static_cast<uint32_t>(offset + rowSize * height);
+
+  BITMAPINFOHEADER infoHeader{};
+  infoHeader.biSize = sizeof(BITMAPINFOHEADER);
+  infoHeader.biWidth = static_cast<int32_t>(width);
+  infoHeader.biHeight = static_cast<int32_t>(height);
+  infoHeader.biPlanes = 1U;
+  infoHeader.biBitCount = supported_bits;
+  infoHeader.biSizeImage = static_cast<uint32_t>(rowSize * height);
+  infoHeader.biClrUsed = palette_size;
+
+  dst.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+  dst.write(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader));
+
+  for (uint32_t color = 0U; color < palette_size; ++color) {
+    const unsigned char c = static_cast<unsigned char>(color);
+    const unsigned char entry[] = {c, c, c, 0U};
+    dst.write(reinterpret_cast<const char*>(entry), sizeof(entry));
+  }
+
+  static const unsigned char padding[row_alignment] = {};
+  const auto padsize = static_cast<std::streamsize>(rowSize - width);
+
+  // The BMP rows are stored bottom-up, the image data is top-down. The rows
+  // go out straight from the image buffer, only the padding is added
+  for (size_t crow = height; crow > 0U; --crow) {
+    dst.write(reinterpret_cast<const char*>(idata.data() + (crow - 1U) * width),
+              static_cast<std::streamsize>(width));
+
+    if (padsize > 0) {
+      dst.write(reinterpret_cast<const char*>(padding), padsize);
+    }
+  }
+
+  if (!dst) {
+    int err = errno;
+    LOGE("File contains failure: " << strerror(err));
+  }
+
+  return static_cast<bool>(dst);
+}
+
+}  // namespace barchclib0::writers
@@ -0,0 +1,48 @@
+#ifndef THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMPIMAGEWRITER_CLASS_H
+#define THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMPIMAGEWRITER_CLASS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+#include "IBarchImage.h"
+#include "src/lib/libmain/images/BMPImage.h"
+
+namespace barchclib0::writers
+{
+
+/**
+ * @brief The 8-bit grayscale BMP image writer class. Stores the image rows
+ * bottom-up with the 4 bytes row alignment and the grayscale palette.
+ */
+class BMPWriter : public std::enable_shared_from_this<BMPWriter>
+{
+ public:
+  using BMPWriterPtr = std::shared_ptr<BMPWriter>;
+
+  virtual ~BMPWriter() = default;
+  BMPWriter() = default;
+
+  virtual bool write(BMPImagePtr image);
+  virtual bool write(BMPImagePtr image, const std::filesystem::path& dstpath);
+
+  static BMPWriterPtr create();
+
+ private:
+  inline static constexpr const uint16_t bmp_magic = 0x4D42;
+  inline static constexpr const uint16_t supported_bits = 8U;
+  inline static constexpr const uint32_t palette_size = 256U;
+  inline static constexpr const size_t row_alignment = 4U;
+  inline static constexpr const size_t max_int32_t =
+      static_cast<size_t>(std::numeric_limits<int32_t>::max());
+
+  bool write(BMPImagePtr image, std::ofstream& dst);
+};
+
+using BMPWriterPtr = BMPWriter::BMPWriterPtr;
+
+}  // namespace barchclib0::writers
+
+#endif  // THE_BMP_2_BARCH_IMAGE_CODER_PROJECT_BMPIMAGEWRITER_CLASS_H
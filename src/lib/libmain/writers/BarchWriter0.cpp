@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <string.h>
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <cmath>
@@ -10,10 +11,12 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "IBarchImage.h"
 #include "src/log/log.h"
+#include "src/log/trace.h"
 
 namespace barchclib0::writers
 {
@@ -46,6 +49,8 @@ bool BarchWriter0::write(BarchImagePtr image,
     return false;
   }
 
+  TRACE_SPAN_FILE("io", "BarchWriter0::write", dstpath.string());
+
   try {
     LOGT("Trying to open file " << dstpath);
     std::ofstream dstfile(dstpath,
@@ -88,9 +93,11 @@ bool BarchWriter0::write(BarchImagePtr image, std::ofstream& dst)
     return false;
   }
 
-  const auto& idata = image->data();
+  const auto& scans = image->scanlines();
 
-  if (idata.empty()) {
+  if (std::all_of(scans.begin(), scans.end(),
+                  [](const barchdata& scan) { return scan.empty(); }) &&
+      !image->has_fills() && !image->has_refs()) {
     LOGE("Image with invalid data buffer provided");
     return false;
   }
@@ -117,7 +124,52 @@ bool BarchWriter0::write(BarchImagePtr image, std::ofstream& dst)
     return false;
   }
 
-  dst << BARCH0_STARTER;
+  if (image->has_fills() && !row_fills(image->format())) {
+    LOGE("The uniform rows can't be expressed with the image format variant");
+    return false;
+  }
+
+  if (image->has_refs() && !row_refs(image->format())) {
+    LOGE("The repeated rows can't be expressed with the image format variant");
+    return false;
+  }
+
+  if (image->has_predicted() && !row_predicts(image->format())) {
+    LOGE("The predicted rows can't be expressed with the image format variant");
+    return false;
+  }
+
+  if (entropy_coded(image->format()) &&
+      image->entropy_lengths().size() != converters::PixelHuffman0::symbols) {
+    LOGE("The entropy coded image has no valid code lengths table");
+    return false;
+  }
+
+  for (size_t row = 0U; row < image->height(); ++row) {
+    const size_t ref = image->row_ref(row);
+
+    if (ref > row || ref > row_ref_window) {
+      LOGE("Invalid reference " << ref << " of the row " << row);
+      return false;
+    }
+  }
+
+  const bool thumbnail = image->has_thumbnail();
+
+  if (thumbnail && (image->thumbnail_width() > max_thumbnail_side ||
+                    image->thumbnail_height() > max_thumbnail_side)) {
+    LOGE("The thumbnail " << image->thumbnail_width() << "x"
+                          << image->thumbnail_height() << " is too large");
+    return false;
+  }
+
+  std::string fstarter = starter(image->format());
+
+  if (thumbnail) {
+    fstarter[thumbnail_mark_at] = thumbnail_mark;
+  }
+
+  dst << fstarter;
 
   uint32_t tdim = static_cast<uint32_t>(image->width());
   dst.write(reinterpret_cast<char*>(&tdim), sizeof(uint32_t));
@@ -125,22 +177,37 @@ bool BarchWriter0::write(BarchImagePtr image, std::ofstream& dst)
   tdim = static_cast<uint32_t>(image->height());
   dst.write(reinterpret_cast<char*>(&tdim), sizeof(uint32_t));
 
-  barchdata linesdata = collect_lines_data(image);
+  if (thumbnail && !put_thumbnail(image, dst)) {
+    LOGE("Fail to put the thumbnail into the file");
+    return false;
+  }
 
-  if (!put_data(linesdata, dst)) {
-    LOGE("Fail to put the lines table into the file");
+  if (entropy_coded(image->format()) &&
+      !put_data(image->entropy_lengths(), dst)) {
+    LOGE("Fail to put the code lengths table into the file");
     return false;
   }
 
-  linesdata.clear();
+  barchdata linesdata;
 
-  linesdata = idata;
+  {
+    TRACE_SPAN("codec", "BarchWriter0::collect_lines_data");
+    linesdata = collect_lines_data(image);
+  }
 
   if (!put_data(linesdata, dst)) {
-    LOGE("Fail to put the data into the file");
+    LOGE("Fail to put the lines table into the file");
     return false;
   }
 
+  // The rows go out straight from the image buffers
+  for (const auto& scan : scans) {
+    if (!put_data(scan, dst)) {
+      LOGE("Fail to put the data into the file");
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -154,12 +221,24 @@ barchdata BarchWriter0::collect_lines_data(BarchImagePtr image)
   unsigned char data = zero;
   unsigned char data_left = ucharbits;
 
-  for (const bool& b : image->lines_table()) {
-    data <<= 1;
-    if (b) {
-      data |= 1U;
+  const auto& lt = image->lines_table();
+  const auto code_bits =
+      static_cast<unsigned char>(table_code_bits(image->format()));
+
+  for (size_t row = 0U; row < lt.size(); ++row) {
+    unsigned char code = lt[row] ? row_compressed : row_raw;
+
+    if (image->row_ref(row) != 0U) {
+      code = static_cast<unsigned char>(row_reference |
+                                        (image->row_ref(row) - 1U));
+    } else if (image->row_fill(row) != RowFill::none) {
+      code = image->row_fill(row) == RowFill::whites ? row_whites : row_blacks;
+    } else if (image->row_predicted(row)) {
+      code = row_predicted;
     }
-    data_left--;
+
+    data = static_cast<unsigned char>(data << code_bits) | code;
+    data_left -= code_bits;
 
     if (data_left == 0) {
       LOGT("Emplacing: " << std::bitset<8>(data));
@@ -179,9 +258,23 @@ barchdata BarchWriter0::collect_lines_data(BarchImagePtr image)
   return linesdata;
 }
 
-bool BarchWriter0::put_data(barchdata& data, std::ofstream& dst)
+bool BarchWriter0::put_thumbnail(BarchImagePtr image, std::ofstream& dst)
 {
-  dst.write(reinterpret_cast<char*>(data.data()),
+  assert(image != nullptr);
+  assert(image->has_thumbnail());
+
+  const barchdata dims{
+      static_cast<unsigned char>(image->thumbnail_width()),
+      static_cast<unsigned char>(image->thumbnail_height())};
+
+  return put_data(dims, dst) && put_data(image->thumbnail(), dst);
+}
+
+bool BarchWriter0::put_data(const barchdata& data, std::ofstream& dst)
+{
+  TRACE_SPAN("io", "BarchWriter0::put_data");
+
+  dst.write(reinterpret_cast<const char*>(data.data()),
             static_cast<std::streamsize>(data.size()));
 
   if (!dst) {
@@ -37,7 +37,10 @@ class BarchWriter0 : public std::enable_shared_from_this<BarchWriter0>,
 
   barchdata collect_lines_data(BarchImagePtr image);
 
-  bool put_data(barchdata& data, std::ofstream& dst);
+  /// @brief The thumbnail section: the 1 byte sides and the raw pixels
+  bool put_thumbnail(BarchImagePtr image, std::ofstream& dst);
+
+  bool put_data(const barchdata& data, std::ofstream& dst);
 };
 
 using BarchWriter0Ptr = BarchWriter0::BarchWriter0Ptr;
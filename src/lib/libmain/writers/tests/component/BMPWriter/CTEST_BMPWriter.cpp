@@ -0,0 +1,120 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "src/lib/libmain/images/BMPImage.h"
+#include "src/lib/libmain/readers/BMPReader.h"
+#include "src/lib/libmain/writers/BMPWriter.h"
+
+using namespace barchclib0;
+using namespace barchclib0::writers;
+using namespace testing;
+
+class CTEST_BMPWriter : public Test
+{
+ public:
+  inline static const std::filesystem::path testbmpdir =
+      std::filesystem::temp_directory_path() / "tests" / "barch-coder" /
+      "ctests" / "CTEST_BMPWriter";
+  inline static const std::filesystem::path testbmp = testbmpdir / "test.bmp";
+
+  CTEST_BMPWriter() : writer{BMPWriter::create()}
+  {
+    EXPECT_NE(writer, nullptr);
+
+    if (!std::filesystem::is_directory(testbmpdir)) {
+      EXPECT_TRUE(std::filesystem::create_directories(testbmpdir));
+    }
+  }
+
+  static BMPImagePtr create_image(const size_t& width, const size_t& height)
+  {
+    auto bmp = BMPImage::create();
+
+    bmp->width(width);
+    bmp->height(height);
+
+    barchdata data(width * height);
+
+    for (size_t iter = 0U; iter < data.size(); ++iter) {
+      data[iter] = static_cast<unsigned char>(iter * 7U % 256U);
+    }
+
+    bmp->data(std::move(data));
+    bmp->filepath(testbmp);
+
+    return bmp;
+  }
+
+  void check_round_trip(const size_t& width, const size_t& height)
+  {
+    auto bmp = create_image(width, height);
+
+    EXPECT_TRUE(writer->write(bmp));
+
+    auto reader = readers::BMPReader::create();
+    auto readbmp = reader->read(testbmp);
+
+    ASSERT_NE(readbmp, nullptr);
+
+    EXPECT_EQ(readbmp->width(), width);
+    EXPECT_EQ(readbmp->height(), height);
+    EXPECT_EQ(readbmp->data(), bmp->data());
+  }
+
+  BMPWriterPtr writer;
+};
+
+TEST_F(CTEST_BMPWriter, aligned_width_round_trip_success)
+{
+  check_round_trip(16U, 9U);
+}
+
+TEST_F(CTEST_BMPWriter, padded_width_round_trip_success)
+{
+  check_round_trip(13U, 7U);
+}
+
+TEST_F(CTEST_BMPWriter, single_pixel_round_trip_success)
+{
+  check_round_trip(1U, 1U);
+}
+
+TEST_F(CTEST_BMPWriter, file_size_matches_row_alignment)
+{
+  auto bmp = create_image(5U, 3U);
+
+  EXPECT_TRUE(writer->write(bmp));
+
+  static constexpr const size_t headers = 14U + 40U + 256U * 4U;
+  static constexpr const size_t alignedRow = 8U;
+
+  EXPECT_EQ(std::filesystem::file_size(testbmp), headers + alignedRow * 3U);
+}
+
+TEST_F(CTEST_BMPWriter, empty_image_failure)
+{
+  auto bmp = BMPImage::create();
+
+  EXPECT_FALSE(writer->write(bmp, testbmp));
+}
+
+TEST_F(CTEST_BMPWriter, data_size_mismatch_failure)
+{
+  auto bmp = create_image(4U, 4U);
+
+  bmp->height(5U);
+
+  EXPECT_FALSE(writer->write(bmp));
+}
+
+TEST_F(CTEST_BMPWriter, no_path_failure)
+{
+  auto bmp = create_image(4U, 4U);
+
+  EXPECT_FALSE(writer->write(bmp, std::filesystem::path{}));
+}
+
+TEST_F(CTEST_BMPWriter, nullptr_failure) { EXPECT_FALSE(writer->write(nullptr)); }
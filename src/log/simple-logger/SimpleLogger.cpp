@@ -10,6 +10,8 @@
 #include <string>
 #include <thread>
 
+#include "src/log/trace.h"
+
 namespace simple_logger
 {
 
@@ -19,7 +21,14 @@ void SimpleLogger::log(const unsigned short& loglvl, const std::string& msg)
     return;
   }
 
-  std::lock_guard<std::mutex> alogfile_m_guard{alogfile_m};
+  std::unique_lock<std::mutex> alogfile_m_guard{alogfile_m, std::defer_lock};
+
+  {
+    TRACE_SPAN("log", "SimpleLogger mutex wait");
+    alogfile_m_guard.lock();
+  }
+
+  TRACE_SPAN("log", "SimpleLogger::log");
 
   std::ostringstream finalLog;
 
@@ -0,0 +1,221 @@
+#include "src/log/simple-tracer/SimpleTracer.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simple_tracer
+{
+
+SimpleTracer::ThreadBuffer::ThreadBuffer()
+    : tid{next_tid.fetch_add(1U)}, name{default_thread_name}
+{
+  std::lock_guard<std::mutex> buffers_m_guard{buffers_m};
+
+  buffers.insert(this);
+}
+
+SimpleTracer::ThreadBuffer::~ThreadBuffer()
+{
+  std::lock_guard<std::mutex> buffers_m_guard{buffers_m};
+  std::lock_guard<std::mutex> m_guard{m};
+
+  retired.insert(retired.end(), std::make_move_iterator(events.begin()),
+                 std::make_move_iterator(events.end()));
+  retired_names.emplace_back(tid, name);
+
+  buffers.erase(this);
+}
+
+void SimpleTracer::init(const std::string& filepath)
+{
+  if (filepath.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> buffers_m_guard{buffers_m};
+
+  tracepath = filepath;
+  start = std::chrono::steady_clock::now();
+  active.store(true);
+}
+
+bool SimpleTracer::enabled() { return active.load(std::memory_order_relaxed); }
+
+SimpleTracer::timestamp SimpleTracer::now()
+{
+  using namespace std::chrono;
+
+  return static_cast<timestamp>(
+      duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+SimpleTracer::ThreadBuffer& SimpleTracer::local_buffer()
+{
+  thread_local ThreadBuffer buffer;
+
+  return buffer;
+}
+
+void SimpleTracer::record(Event&& ev)
+{
+  ThreadBuffer& buffer = local_buffer();
+
+  std::lock_guard<std::mutex> m_guard{buffer.m};
+
+  ev.tid = buffer.tid;
+  buffer.events.emplace_back(std::move(ev));
+}
+
+void SimpleTracer::thread_name(const std::string& name)
+{
+  if (!enabled()) {
+    return;
+  }
+
+  ThreadBuffer& buffer = local_buffer();
+
+  std::lock_guard<std::mutex> m_guard{buffer.m};
+
+  buffer.name = name;
+}
+
+bool SimpleTracer::flush()
+{
+  if (!enabled()) {
+    return true;
+  }
+
+  std::vector<Event> events;
+  std::vector<std::pair<unsigned int, std::string>> names;
+  std::string path;
+
+  {
+    std::lock_guard<std::mutex> buffers_m_guard{buffers_m};
+
+    path = tracepath;
+    events = retired;
+    names = retired_names;
+
+    for (ThreadBuffer* buffer : buffers) {
+      std::lock_guard<std::mutex> m_guard{buffer->m};
+
+      events.insert(events.end(), buffer->events.begin(),
+                    buffer->events.end());
+      names.emplace_back(buffer->tid, buffer->name);
+    }
+  }
+
+  std::ofstream trace{path, std::ofstream::trunc};
+
+  if (!trace.is_open()) {
+    return false;
+  }
+
+  trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+
+  for (const auto& [tid, name] : names) {
+    trace << (first ? "\n" : ",\n");
+    write_thread_name(trace, tid, name);
+    first = false;
+  }
+
+  for (const Event& ev : events) {
+    trace << (first ? "\n" : ",\n");
+    write_event(trace, ev);
+    first = false;
+  }
+
+  trace << "\n]}\n";
+
+  return static_cast<bool>(trace);
+}
+
+void SimpleTracer::write_event(std::ostream& os, const Event& ev)
+{
+  os << "{\"name\":";
+  write_escaped(os, ev.name);
+  os << ",\"cat\":";
+  write_escaped(os, ev.category);
+  os << ",\"ph\":\"X\",\"ts\":" << ev.ts << ",\"dur\":" << ev.dur
+     << ",\"pid\":" << trace_pid << ",\"tid\":" << ev.tid;
+
+  if (!ev.file.empty()) {
+    os << ",\"args\":{\"file\":";
+    write_escaped(os, ev.file);
+    os << "}";
+  }
+
+  os << "}";
+}
+
+void SimpleTracer::write_thread_name(std::ostream& os, const unsigned int& tid,
+                                     const std::string& name)
+{
+  os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << trace_pid
+     << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+  write_escaped(os, name + " #" + std::to_string(tid));
+  os << "}}";
+}
+
+void SimpleTracer::write_escaped(std::ostream& os, const std::string& str)
+{
+  static constexpr const unsigned char lastControl = 0x1F;
+
+  os << '"';
+
+  for (const char c : str) {
+    const unsigned char uc = static_cast<unsigned char>(c);
+
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (uc <= lastControl) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+         << static_cast<unsigned int>(uc) << std::dec;
+    } else {
+      os << c;
+    }
+  }
+
+  os << '"';
+}
+
+TraceSpan::TraceSpan(const char* category, const char* name)
+    : mactive{SimpleTracer::enabled()}
+{
+  if (!mactive) {
+    return;
+  }
+
+  mevent.category = category;
+  mevent.name = name;
+  mevent.ts = SimpleTracer::now();
+}
+
+TraceSpan::TraceSpan(const char* category, const char* name,
+                     const std::string& file)
+    : TraceSpan(category, name)
+{
+  if (mactive) {
+    mevent.file = file;
+  }
+}
+
+TraceSpan::~TraceSpan()
+{
+  if (!mactive) {
+    return;
+  }
+
+  mevent.dur = SimpleTracer::now() - mevent.ts;
+
+  SimpleTracer::record(std::move(mevent));
+}
+
+}  // namespace simple_tracer
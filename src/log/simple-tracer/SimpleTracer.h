@@ -0,0 +1,140 @@
+#ifndef YOUR_CPP_APP_TEMPLATE_PROJECT_SIMPLE_TRACER_IMPLEMENTATION_CLASS_H
+#define YOUR_CPP_APP_TEMPLATE_PROJECT_SIMPLE_TRACER_IMPLEMENTATION_CLASS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The simple trace-event recorder encapsulation namespace.
+ */
+namespace simple_tracer
+{
+
+/**
+ * @brief The simple scoped-span tracer. Collects complete duration events
+ * per thread and writes them as the Chrome/Perfetto trace-event JSON file
+ * (open it with the chrome://tracing or the ui.perfetto.dev).
+ *
+ * Recording is disabled until the init method is called with a non-empty
+ * file path, so spans cost a single atomic load in the regular runs.
+ */
+class SimpleTracer
+{
+ public:
+  using timestamp = uint64_t;
+
+  /**
+   * @brief The single complete ("X" phase) trace event.
+   */
+  struct Event
+  {
+    const char* category{nullptr};
+    const char* name{nullptr};
+    std::string file;
+    timestamp ts{0U};
+    timestamp dur{0U};
+    unsigned int tid{0U};
+  };
+
+  inline static constexpr const char* const default_thread_name = "thread";
+
+  virtual ~SimpleTracer() = default;
+  SimpleTracer() = default;
+
+  /**
+   * @brief Init the tracer and start recording of the spans.
+   *
+   * @param filepath The trace JSON file path to write the events into during
+   * the flush. If empty string given - tracing stays disabled.
+   */
+  static void init(const std::string& filepath);
+
+  /// @brief Returns true if the spans should be recorded.
+  static bool enabled();
+
+  /// @brief Current timestamp in microseconds since the init call.
+  static timestamp now();
+
+  /// @brief Stores the finished event into the current thread buffer.
+  static void record(Event&& ev);
+
+  /**
+   * @brief Sets the current thread name shown on the timeline.
+   *
+   * @param name The thread name, for example "FileListModel worker".
+   */
+  static void thread_name(const std::string& name);
+
+  /**
+   * @brief Writes all the recorded events into the init file path.
+   *
+   * @return Returns true on success or if tracing is disabled and false in
+   * case of the file write failure.
+   */
+  static bool flush();
+
+ private:
+  /**
+   * @brief The per-thread events storage. Registered in the buffers set
+   * during first use and moves its events into the retired storage during
+   * the thread exit.
+   */
+  struct ThreadBuffer
+  {
+    ThreadBuffer();
+    ~ThreadBuffer();
+
+    std::mutex m;
+    unsigned int tid{0U};
+    std::string name;
+    std::vector<Event> events;
+  };
+
+  static ThreadBuffer& local_buffer();
+
+  static void write_event(std::ostream& os, const Event& ev);
+  static void write_thread_name(std::ostream& os, const unsigned int& tid,
+                                const std::string& name);
+  static void write_escaped(std::ostream& os, const std::string& str);
+
+  inline static constexpr const unsigned int trace_pid = 1U;
+
+  inline static std::atomic_bool active{false};
+  inline static std::atomic_uint next_tid{1U};
+  inline static std::chrono::steady_clock::time_point start{};
+  inline static std::string tracepath;
+
+  inline static std::mutex buffers_m;
+  inline static std::set<ThreadBuffer*> buffers;
+  inline static std::vector<Event> retired;
+  inline static std::vector<std::pair<unsigned int, std::string>> retired_names;
+};
+
+/**
+ * @brief The RAII span. Records the complete event from the construction
+ * till the destruction if tracing is enabled.
+ */
+class TraceSpan
+{
+ public:
+  TraceSpan(const char* category, const char* name);
+  TraceSpan(const char* category, const char* name, const std::string& file);
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  bool mactive{false};
+  SimpleTracer::Event mevent;
+};
+
+}  // namespace simple_tracer
+
+#endif  // YOUR_CPP_APP_TEMPLATE_PROJECT_SIMPLE_TRACER_IMPLEMENTATION_CLASS_H
@@ -0,0 +1,55 @@
+#ifndef YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H
+#define YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H
+
+#include "src/log/simple-tracer/SimpleTracer.h"
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifndef TRACE_INIT
+/**
+ * @brief The tracing init macros. Enables the spans recording into the
+ * given Chrome trace-event JSON file path. Empty path keeps tracing off.
+ */
+#define TRACE_INIT(filepath) simple_tracer::SimpleTracer::init(filepath);
+#endif  // TRACE_INIT
+
+#ifndef TRACE_FLUSH
+/**
+ * @brief Writes all the recorded spans into the trace file. Evaluates to
+ * false in case of the trace file write failure.
+ */
+#define TRACE_FLUSH() simple_tracer::SimpleTracer::flush()
+#endif  // TRACE_FLUSH
+
+#ifndef TRACE_THREAD_NAME
+/**
+ * @brief Names the current thread on the trace timeline.
+ */
+#define TRACE_THREAD_NAME(name) simple_tracer::SimpleTracer::thread_name(name);
+#endif  // TRACE_THREAD_NAME
+
+#ifndef TRACE_SPAN
+/**
+ * @brief Records the span from the macro line till the end of the current
+ * scope.
+ *
+ * @param category The span category, like "io", "codec", "log" or "ui".
+ * @param name The span name literal.
+ */
+#define TRACE_SPAN(category, name)                                  \
+  simple_tracer::TraceSpan TRACE_CONCAT(traceSpanHolder, __LINE__)( \
+      category, name);
+#endif  // TRACE_SPAN
+
+#ifndef TRACE_SPAN_FILE
+/**
+ * @brief Same as the TRACE_SPAN but attaches the processed file path to the
+ * span arguments so per-file spans may be filtered on the timeline.
+ */
+#define TRACE_SPAN_FILE(category, name, filepath)                   \
+  simple_tracer::TraceSpan TRACE_CONCAT(traceSpanHolder, __LINE__)( \
+      category, name, filepath);
+#endif  // TRACE_SPAN_FILE
+
+#endif  // YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H
@@ -11,6 +11,7 @@
 #include "src/qt6/QMLRes.h"
 #include "src/qt6/models/ErrorSingleModel.h"
 #include "src/qt6/models/FileListModel.h"
+#include "src/qt6/providers/BarchImageProvider.h"
 
 namespace Qt6i
 {
@@ -21,6 +22,7 @@ int Qt6Initer::run(std::shared_ptr<app::ApplicationContext> actx)
   using FileListModel = models::FileListModel;
   using ErrorSingleModel = models::ErrorSingleModel;
   using QMLRes = qmlpaths::QMLRes;
+  using BarchImageProvider = providers::BarchImageProvider;
 
   assert(actx != nullptr);
 
@@ -29,16 +31,8 @@ int Qt6Initer::run(std::shared_ptr<app::ApplicationContext> actx)
     return app::IApplication::INVALID;
   }
 
-  FileListModelPtr imagesModel = FileListModel::create();
   ErrorSingleModel& errorModel = ErrorSingleModel::instance();
 
-  assert(imagesModel != nullptr);
-
-  if (imagesModel == nullptr || !imagesModel->init()) {
-    LOGE("Failure with filelist model");
-    return app::IApplication::INVALID;
-  }
-
   if (!actx->errors.empty()) {
     errorModel.setError(QString::fromStdString(actx->errors.back()));
   }
@@ -47,10 +41,25 @@ int Qt6Initer::run(std::shared_ptr<app::ApplicationContext> actx)
       QString::fromStdString(project_decls::PROJECT_NAME));
 
   QGuiApplication app(actx->argc, actx->argv);
+
+  // The directory is listed in the background, the rows come as the
+  // event loop runs
+  FileListModelPtr imagesModel = FileListModel::create();
+
+  assert(imagesModel != nullptr);
+
+  if (imagesModel == nullptr || !imagesModel->init()) {
+    LOGE("Failure with filelist model");
+    return app::IApplication::INVALID;
+  }
   QQmlApplicationEngine engine;
 
   engine.addImportPath(QMLRes::components_path);
 
+  // The engine takes the provider ownership
+  engine.addImageProvider(BarchImageProvider::provider_id,
+                          new BarchImageProvider());
+
   engine.rootContext()->setContextProperty("ImagesFilesListProvider",
                                            imagesModel.get());
   engine.rootContext()->setContextProperty("ErrorProvider", &errorModel);
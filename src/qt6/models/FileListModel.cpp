@@ -1,14 +1,20 @@
 #include "src/qt6/models/FileListModel.h"
 
 #include <QAbstractListModel>
-#include <QImage>
+#include <QMetaObject>
 #include <QString>
 #include <QStringList>
+#include <chrono>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
 
 #include "src/log/log.h"
+#include "src/log/trace.h"
 #include "src/qt6/models/ErrorSingleModel.h"
 
 #define CUSTOM_UILOGE(msg)                                                    \
@@ -22,35 +28,34 @@
 namespace Qt6i::models
 {
 
+namespace
+{
+
+const QString encoding = QStringLiteral("Кодується");
+const QString decoding = QStringLiteral("Розкодовується");
+const QString done = QStringLiteral("Зроблено");
+const QString error = QStringLiteral("Помилка!");
+
+}  // namespace
+
 FileListModel::~FileListModel()
 {
-  LOGD("Waiting threads");
-  for (auto thp : mthqueue) {
-    if (thp->joinable()) {
-      thp->join();
-    }
-  }
+  stop_scan();
+
+  LOGD("Waiting conversions");
+
+  std::unique_lock<std::mutex> lock{mpendingm};
+
+  mpendingcv.wait(lock, [this] { return mpending == 0U; });
+
   LOGD("Done!");
 }
 
 FileListModel::FileListModel(QObject *parent)
-    : QAbstractListModel{parent}, cfactory{}
+    : QAbstractListModel{parent}, cfactory{}, mconverter{cfactory.create()}
 {
 }
 
-void FileListModel::clean_threads()
-{
-  LOGD("Cleaning finished threads");
-
-  for (auto thiter = mthqueue.begin(); thiter != mthqueue.end(); ++thiter) {
-    auto thp = *thiter;
-
-    if (!thp->joinable()) {
-      thiter = mthqueue.erase(thiter);
-    }
-  }
-}
-
 int FileListModel::rowCount(const QModelIndex &parent) const
 {
   Q_UNUSED(parent);
@@ -107,118 +112,104 @@ void FileListModel::emit_row_data_update(QModelIndex idx)
   emit dataChanged(idx, idx, {ImageOperationRole});
 }
 
-bool FileListModel::thread_perform(barchclib0::ILibPtr converter,
-                                   ImageFileModelPtr model, QModelIndex idx)
+void FileListModel::on_read(muteximagepair ipair, QModelIndex idx,
+                            barchclib0::IBarchImagePtr img)
 {
-  static const QString encoding = QStringLiteral("Кодується");
-  static const QString decoding = QStringLiteral("Розкодовується");
-  static const QString done = QStringLiteral("Зроблено");
-  static const QString error = QStringLiteral("Помилка!");
+  const ImageFileModelPtr model = ipair.second;
+
+  TRACE_SPAN_FILE("ui", "FileListModel::on_read", model->filepath().string());
+
+  if (img == nullptr) {
+    CUSTOM_UILOGE("Fail while reading the image");
+    finish(ipair, idx, false);
+    return;
+  }
+
+  auto next = [this, ipair, idx](barchclib0::IBarchImagePtr converted) {
+    on_converted(ipair, idx, converted);
+  };
 
   if (is_bmp(model->filepath())) {
     model->current_operation(encoding.toUtf8().constData());
     emit_row_data_update(idx);
-    if (!thread_deal_bmp(converter, model)) {
-      CUSTOM_UILOGE("Failure while dealing with the BMP " << model->filepath());
-      model->current_operation(error.toUtf8().constData());
-      emit_row_data_update(idx);
-      return false;
-    }
-  } else if (is_barch(model->filepath())) {
+    mconverter->bmp_to_barch_async(img, next);
+  } else {
     model->current_operation(decoding.toUtf8().constData());
     emit_row_data_update(idx);
-    if (!thread_deal_barch(converter, model)) {
-      CUSTOM_UILOGE("Failure while dealing with the Barch "
-                    << model->filepath());
-      model->current_operation(error.toUtf8().constData());
-      emit_row_data_update(idx);
-      return false;
-    }
-  } else {
-    CUSTOM_UILOGE("Unknown file type" << model->filepath());
+    mconverter->barch_to_bmp_async(img, next);
   }
-
-  model->current_operation(done.toUtf8().constData());
-  emit_row_data_update(idx);
-
-  return true;
 }
 
-bool FileListModel::thread_deal_bmp(barchclib0::ILibPtr converter,
-                                    ImageFileModelPtr model)
+void FileListModel::on_converted(muteximagepair ipair, QModelIndex idx,
+                                 barchclib0::IBarchImagePtr img)
 {
-  auto img = converter->read(model->filepath());
+  const ImageFileModelPtr model = ipair.second;
+
+  TRACE_SPAN_FILE("ui", "FileListModel::on_converted",
+                  model->filepath().string());
 
   if (img == nullptr) {
-    CUSTOM_UILOGE("Fail while reading the image");
-    return false;
+    CUSTOM_UILOGE("Failure during the conversion of " << model->filepath());
+    finish(ipair, idx, false);
+    return;
   }
 
-  // encode here!
-  auto barch = converter->bmp_to_barch(img);
+  const std::string suffix =
+      is_bmp(model->filepath()) ? "packed.barch" : "unpacked.bmp";
 
-  if (barch == nullptr) {
-    CUSTOM_UILOGE("Failure during the barch conversion");
-    return false;
-  }
+  const std::filesystem::path target =
+      model->filepath().parent_path() /
+      (model->filepath().filename().string() + suffix);
 
-  auto nfilepath = model->filepath().parent_path() /
-                   (model->filepath().filename().string() + "packed.barch");
+  img->filepath(target);
 
-  barch->filepath(nfilepath);
+  mconverter->write_async(img, [this, ipair, idx, target](bool success) {
+    TRACE_SPAN_FILE("io", "FileListModel::on_written", target.string());
 
-  if (!converter->write(barch)) {
-    CUSTOM_UILOGE("Failure during barch save");
-    return false;
-  }
+    if (!success) {
+      CUSTOM_UILOGE("Failure during save of " << ipair.second->filepath());
+    }
 
-  return true;
+    finish(ipair, idx, success);
+  });
 }
 
-bool FileListModel::thread_deal_barch(barchclib0::ILibPtr converter,
-                                      ImageFileModelPtr model)
+void FileListModel::finish(muteximagepair ipair, QModelIndex idx,
+                           const bool &success)
 {
-  auto img = converter->read(model->filepath());
+  TRACE_SPAN_FILE("ui", "FileListModel::finish",
+                  ipair.second->filepath().string());
 
-  if (img == nullptr) {
-    CUSTOM_UILOGE("Fail while reading the image");
-    return false;
+  if (success) {
+    LOGI("successful process of " << ipair.second->filepath());
+    ipair.second->current_operation(done.toUtf8().constData());
+  } else {
+    ipair.second->current_operation(error.toUtf8().constData());
   }
 
-  auto bmp = converter->barch_to_bmp(img);
-
-  if (bmp == nullptr) {
-    CUSTOM_UILOGE("Fail to unpack the barch: " << model->filepath());
-    return false;
-  }
+  emit_row_data_update(idx);
 
-  QImage qimg(bmp->data().data(), static_cast<int>(bmp->width()),
-              static_cast<int>(bmp->height()), static_cast<int>(bmp->width()),
-              QImage::Format_Grayscale8);
+  ipair.first->unlock();
 
-  std::filesystem::path newIPath =
-      model->filepath().parent_path() /
-      (model->filepath().filename().string() + "unpacked.bmp");
+  // The last access to this object: the destructor may proceed after it
+  std::lock_guard<std::mutex> guard{mpendingm};
 
-  if (!qimg.save(QString::fromStdString(newIPath.string()))) {
-    CUSTOM_UILOGE("Fail to save image to " << newIPath);
-    return false;
-  }
+  --mpending;
 
-  return true;
+  mpendingcv.notify_all();
 }
 
 void FileListModel::convert_file(const int &gindex)
 {
-  if (gindex < 0 || gindex > imagesSet.size()) {
+  if (gindex < 0 || gindex >= imagesSet.size()) {
     CUSTOM_UILOGE("Invalid index provided");
     return;
   }
 
   auto &ipair = imagesSet.at(gindex);
 
-  if (!ipair.first->try_lock()) {
-    CUSTOM_UILOGE("Image already in processing");
+  if (mconverter == nullptr) {
+    CUSTOM_UILOGE("Fail to create converter instance");
     return;
   }
 
@@ -226,12 +217,13 @@ void FileListModel::convert_file(const int &gindex)
 
   assert(imgptr != nullptr);
 
-  barchclib0::ILibPtr converter = cfactory.create();
-
-  assert(converter != nullptr);
+  if (!is_bmp(imgptr->filepath()) && !is_barch(imgptr->filepath())) {
+    CUSTOM_UILOGE("Unknown file type" << imgptr->filepath());
+    return;
+  }
 
-  if (converter == nullptr) {
-    CUSTOM_UILOGE("Fail to create converter instance");
+  if (!ipair.first->try_lock()) {
+    CUSTOM_UILOGE("Image already in processing");
     return;
   }
 
@@ -239,22 +231,15 @@ void FileListModel::convert_file(const int &gindex)
 
   QModelIndex idx = index(imgptr->index());
 
-  LOGD("Trying to create dealing thread");
-
-  mthqueue.insert(
-      std::make_shared<std::thread>([this, converter, ipair, idx]() {
-        if (!thread_perform(converter, ipair.second, idx)) {
-          CUSTOM_UILOGE("Failure during task performing");
-          ipair.first->unlock();
-          return;
-        }
-
-        LOGI("successful process of " << ipair.second->filepath());
-
-        ipair.first->unlock();
-      }));
+  {
+    std::lock_guard<std::mutex> guard{mpendingm};
+    ++mpending;
+  }
 
-  clean_threads();
+  mconverter->read_async(imgptr->filepath(),
+                         [this, ipair, idx](barchclib0::IBarchImagePtr img) {
+                           on_read(ipair, idx, img);
+                         });
 }
 
 bool FileListModel::is_bmp(const std::filesystem::path &gpath)
@@ -301,11 +286,67 @@ bool FileListModel::init(const std::filesystem::path &dpath)
     return false;
   }
 
+  stop_scan();
+
+  if (!imagesSet.empty()) {
+    beginResetModel();
+    imagesSet.clear();
+    endResetModel();
+  }
+
   LOGD("Listing directory: " << dpath);
 
+  mstopscan = false;
+  const size_t generation = ++mscangeneration;
+
+  mscanner =
+      std::thread([this, dpath, generation] { scan(dpath, generation); });
+
+  return true;
+}
+
+void FileListModel::scan(const std::filesystem::path &dpath,
+                         const size_t &generation)
+{
+  namespace fs = std::filesystem;
+  using clock = std::chrono::steady_clock;
+
+  // The first rows show up at once, not after the whole batch
+  static constexpr const auto flush_period = std::chrono::milliseconds{100};
+
+  ImageFileModelSet batch;
+  size_t listed = 0U;
+  auto flushed = clock::now();
+
+  const auto flush = [this, &batch, &flushed, generation] {
+    if (!batch.empty()) {
+      QMetaObject::invokeMethod(
+          this,
+          [this, images = std::move(batch), generation] {
+            append_images(images, generation);
+          },
+          Qt::QueuedConnection);
+      batch = ImageFileModelSet{};
+    }
+
+    flushed = clock::now();
+  };
+
   try {
-    for (const auto &entry : fs::directory_iterator(dpath)) {
-      if (!fs::is_regular_file(entry.path())) {
+    std::error_code ec;
+
+    for (fs::directory_iterator iter{dpath, ec}, end; !ec && iter != end;
+         iter.increment(ec)) {
+      if (mstopscan) {
+        LOGD("Directory scan stopped");
+        return;
+      }
+
+      const fs::directory_entry &entry = *iter;
+
+      // The type comes with the listing itself, no stat call for it
+      if (!entry.is_regular_file(ec) || ec) {
+        ec.clear();
         continue;
       }
 
@@ -316,24 +357,79 @@ bool FileListModel::init(const std::filesystem::path &dpath)
         continue;
       }
 
-      auto cimage = ImageFileModel::create(entry.path());
+      const auto size = entry.file_size(ec);
 
-      cimage->index(imagesSet.size());
+      if (ec) {
+        LOGE("Fail to read the size of " << entry.path() << ": "
+                                         << ec.message());
+        ec.clear();
+        continue;
+      }
 
-      LOGT("new image index: " << cimage->index());
+      batch.emplace_back(std::make_shared<std::mutex>(),
+                         ImageFileModel::create(entry.path(), size));
+      ++listed;
+
+      if (batch.size() >= scan_batch || clock::now() - flushed > flush_period) {
+        flush();
+      }
+    }
 
-      muteximagepair p(std::make_shared<std::mutex>(),
-                       ImageFileModelPtr(cimage));
+    if (ec) {
+      const std::string message = ec.message();
 
-      imagesSet.emplace_back(p);
+      QMetaObject::invokeMethod(
+          this,
+          [message] {
+            CUSTOM_UILOGE("Error during fs traverse: " << message);
+          },
+          Qt::QueuedConnection);
     }
   }
   catch (const std::exception &e) {
-    CUSTOM_UILOGE("Error during fs traverse: " << e.what());
-    return 1;
+    const std::string message = e.what();
+
+    QMetaObject::invokeMethod(
+        this,
+        [message] { CUSTOM_UILOGE("Error during fs traverse: " << message); },
+        Qt::QueuedConnection);
   }
 
-  return true;
+  flush();
+
+  LOGD("Listed " << listed << " images of " << dpath);
+}
+
+void FileListModel::append_images(const ImageFileModelSet &batch,
+                                  const size_t &generation)
+{
+  if (batch.empty() || generation != mscangeneration) {
+    return;
+  }
+
+  const int first = static_cast<int>(imagesSet.size());
+
+  beginInsertRows(QModelIndex(), first,
+                  first + static_cast<int>(batch.size()) - 1);
+
+  for (const auto &ipair : batch) {
+    ipair.second->index(static_cast<int>(imagesSet.size()));
+
+    LOGT("new image index: " << ipair.second->index());
+
+    imagesSet.emplace_back(ipair);
+  }
+
+  endInsertRows();
+}
+
+void FileListModel::stop_scan()
+{
+  mstopscan = true;
+
+  if (mscanner.joinable()) {
+    mscanner.join();
+  }
 }
 
 FileListModelPtr FileListModel::create(QObject *parent)
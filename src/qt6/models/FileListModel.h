@@ -2,10 +2,14 @@
 #define THE_BMP_2_BARCH_CODER_PROJECT_FILELISTMODEL_STRUCT_H
 
 #include <QAbstractListModel>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <filesystem>
 #include <memory>
-#include <set>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "LibraryFacade.h"
 #include "src/qt6/models/ImageFileModel.h"
@@ -31,7 +35,6 @@ class FileListModel : public QAbstractListModel
   using muteximagepair = std::pair<mutexptr, ImageFileModelPtr>;
   using ImageFileModelSet = std::vector<muteximagepair>;
   using FileListModelPtr = std::shared_ptr<FileListModel>;
-  using threadsQueue = std::set<std::shared_ptr<std::thread>>;
 
   virtual ~FileListModel();
   explicit FileListModel(QObject *parent = nullptr);
@@ -48,9 +51,15 @@ class FileListModel : public QAbstractListModel
   /// @brief init object with a current directory path
   bool init();
 
-  /// @brief init object with directory path
+  /**
+   * @brief init object with directory path. The directory is listed on the
+   * background thread, the rows are inserted by the scan_batch images.
+   */
   bool init(const std::filesystem::path &dpath);
 
+  /// @brief The images inserted at once by the directory scan
+  inline static constexpr const size_t scan_batch = 256U;
+
   static FileListModelPtr create(QObject *parent = nullptr);
 
  private:
@@ -58,21 +67,50 @@ class FileListModel : public QAbstractListModel
   static bool is_barch(const std::filesystem::path &gpath);
   static bool is_image(const std::filesystem::path &gpath);
 
-  bool thread_perform(barchclib0::ILibPtr converter, ImageFileModelPtr model,
-                      QModelIndex idx);
-  bool thread_deal_bmp(barchclib0::ILibPtr converter, ImageFileModelPtr model);
-  bool thread_deal_barch(barchclib0::ILibPtr converter,
-                         ImageFileModelPtr model);
+  /// @brief The read stage is done: starts the encoding or decoding
+  void on_read(muteximagepair ipair, QModelIndex idx,
+               barchclib0::IBarchImagePtr img);
+
+  /// @brief The conversion stage is done: starts the write
+  void on_converted(muteximagepair ipair, QModelIndex idx,
+                    barchclib0::IBarchImagePtr img);
+
+  /// @brief Publishes the operation result and releases the image
+  void finish(muteximagepair ipair, QModelIndex idx, const bool &success);
 
   void emit_row_data_update(QModelIndex idx);
 
-  void clean_threads();
+  /**
+   * @brief Lists the directory with the cached entries file types, only the
+   * images sizes are stat-ed. Runs on the scanner thread.
+   */
+  void scan(const std::filesystem::path &dpath, const size_t &generation);
+
+  /**
+   * @brief Inserts the scanned images rows, on the model thread. The batches
+   * of the previous directory scans are dropped.
+   */
+  void append_images(const ImageFileModelSet &batch,
+                     const size_t &generation);
+
+  /// @brief Stops the directory scan in progress, if any
+  void stop_scan();
 
   ImageFileModelSet imagesSet;
 
   barchclib0::LibraryFacade cfactory;
 
-  threadsQueue mthqueue;
+  // The conversions are chained on the library executor
+  barchclib0::ILibPtr mconverter;
+
+  std::mutex mpendingm;
+  std::condition_variable mpendingcv;
+  size_t mpending{0U};
+
+  std::thread mscanner;
+  std::atomic<bool> mstopscan{false};
+  /// @brief The directory scan the rows come from, on the model thread only
+  size_t mscangeneration{0U};
 };
 
 using FileListModelPtr = FileListModel::FileListModelPtr;
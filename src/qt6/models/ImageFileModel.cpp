@@ -21,6 +21,12 @@ ImageFileModel::ImageFileModel(const std::string& gpath) : mpath{gpath}
   }
 }
 
+ImageFileModel::ImageFileModel(const std::filesystem::path& gpath,
+                               const size_t& nsize)
+    : mpath{gpath}, m_size{nsize}
+{
+}
+
 const std::filesystem::path& ImageFileModel::filepath() const { return mpath; }
 
 bool ImageFileModel::filepath(const std::filesystem::path& npath)
@@ -42,6 +48,12 @@ ImageFileModelPtr ImageFileModel::create(const std::filesystem::path& npath)
   return std::make_shared<ImageFileModel>(npath);
 }
 
+ImageFileModelPtr ImageFileModel::create(const std::filesystem::path& npath,
+                                         const size_t& nsize)
+{
+  return std::make_shared<ImageFileModel>(npath, nsize);
+}
+
 bool ImageFileModel::read_file()
 {
   if (mpath.empty()) {
@@ -22,6 +22,8 @@ class ImageFileModel
 
   virtual ~ImageFileModel() = default;
   ImageFileModel(const std::string& gpath);
+  /// @brief The file size is already known: no file stat calls
+  ImageFileModel(const std::filesystem::path& gpath, const size_t& nsize);
 
   const std::filesystem::path& filepath() const;
   bool filepath(const std::filesystem::path& npath);
@@ -29,6 +31,8 @@ class ImageFileModel
   const size_t& bytes_total() const;
 
   static ImageFileModelPtr create(const std::filesystem::path& npath);
+  static ImageFileModelPtr create(const std::filesystem::path& npath,
+                                  const size_t& nsize);
 
   std::string current_operation() const;
   void current_operation(const std::string& opname);
@@ -0,0 +1,317 @@
+#include "src/qt6/providers/BarchImageProvider.h"
+
+#include <QImage>
+#include <QMetaObject>
+#include <QQuickTextureFactory>
+#include <QSize>
+#include <QString>
+#include <QUrl>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "DecodeTarget.h"
+#include "src/log/log.h"
+
+namespace Qt6i::providers
+{
+
+QQuickTextureFactory *BarchImageResponse::textureFactory() const
+{
+  return QQuickTextureFactory::textureFactoryForImage(mimage);
+}
+
+QString BarchImageResponse::errorString() const { return merror; }
+
+void BarchImageResponse::complete(const QImage &image, const QString &error)
+{
+  mimage = image;
+  merror = error;
+
+  // Never before the engine got the response from the request call
+  QMetaObject::invokeMethod(
+      this, [this] { emit finished(); }, Qt::QueuedConnection);
+}
+
+BarchImageProvider::~BarchImageProvider()
+{
+  LOGD("Waiting decodings");
+
+  std::unique_lock<std::mutex> lock{mpendingm};
+
+  mpendingcv.wait(lock, [this] { return mpending == 0U; });
+
+  LOGD("Done!");
+}
+
+BarchImageProvider::BarchImageProvider(const size_t &cache_bytes)
+    : mcache{cache_bytes}, cfactory{}, mdecoder{cfactory.create()}
+{
+}
+
+QQuickImageResponse *BarchImageProvider::requestImageResponse(
+    const QString &id, const QSize &requestedSize)
+{
+  namespace fs = std::filesystem;
+
+  auto *response = new BarchImageResponse();
+
+  const fs::path path =
+      QUrl::fromPercentEncoding(id.toUtf8()).toUtf8().constData();
+
+  if (mdecoder == nullptr || (!is_bmp(path) && !is_barch(path))) {
+    LOGE("Can't serve the image " << path);
+    response->complete({}, QStringLiteral("Unsupported image"));
+    return response;
+  }
+
+  fs::file_time_type modified;
+
+  try {
+    modified = fs::last_write_time(path);
+  }
+  catch (const std::exception &e) {
+    LOGE("Fail to stat " << path << ": " << e.what());
+    response->complete({}, QString::fromStdString(e.what()));
+    return response;
+  }
+
+  // The rewritten files miss the cache
+  const QString key = QStringLiteral("%1@%2x%3#%4")
+                          .arg(QString::fromStdString(path.string()))
+                          .arg(requestedSize.width())
+                          .arg(requestedSize.height())
+                          .arg(modified.time_since_epoch().count());
+
+  const QImage cached = mcache.find(key);
+
+  if (!cached.isNull()) {
+    LOGT("Cached image " << path);
+    response->complete(cached);
+    return response;
+  }
+
+  if (is_barch(path)) {
+    const QImage preview =
+        fit_requested(embedded_thumbnail(path, requestedSize), requestedSize);
+
+    if (!preview.isNull()) {
+      mcache.insert(key, preview);
+      response->complete(preview);
+      return response;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard{mpendingm};
+    ++mpending;
+  }
+
+  mdecoder->read_async(path, [this, response, key, path, requestedSize](
+                                 barchclib0::IBarchImagePtr img) {
+    on_read(response, key, path, requestedSize, img);
+  });
+
+  return response;
+}
+
+void BarchImageProvider::on_read(BarchImageResponse *response,
+                                 const QString &key,
+                                 const std::filesystem::path &path,
+                                 const QSize &requestedSize,
+                                 barchclib0::IBarchImagePtr img)
+{
+  if (img == nullptr) {
+    LOGE("Fail while reading the image " << path);
+    finish(response, key, {}, QStringLiteral("Fail to read the image"));
+    return;
+  }
+
+  QImage image;
+
+  try {
+    image = is_bmp(path) ? to_qimage(img) : decode_barch(img, requestedSize);
+  }
+  catch (const std::exception &e) {
+    LOGE("Exception " << e.what() << " during " << path << " decoding");
+  }
+
+  if (image.isNull()) {
+    LOGE("Fail to decode the image " << path);
+    finish(response, key, {}, QStringLiteral("Fail to decode the image"));
+    return;
+  }
+
+  finish(response, key, fit_requested(image, requestedSize), {});
+}
+
+void BarchImageProvider::finish(BarchImageResponse *response,
+                                const QString &key, const QImage &image,
+                                const QString &error)
+{
+  if (!image.isNull()) {
+    mcache.insert(key, image);
+  }
+
+  response->complete(image, error);
+
+  // The last access to this object: the destructor may proceed after it
+  std::lock_guard<std::mutex> guard{mpendingm};
+
+  --mpending;
+
+  mpendingcv.notify_all();
+}
+
+QImage BarchImageProvider::embedded_thumbnail(
+    const std::filesystem::path &path, const QSize &requestedSize)
+{
+  if (requestedSize.width() <= 0 && requestedSize.height() <= 0) {
+    return {};
+  }
+
+  const auto rwidth = static_cast<size_t>(std::max(0, requestedSize.width()));
+  const auto rheight =
+      static_cast<size_t>(std::max(0, requestedSize.height()));
+
+  barchclib0::IBarchImagePtr thumb = mdecoder->read_thumbnail(path);
+
+  if (thumb == nullptr || thumb->width() < rwidth ||
+      thumb->height() < rheight) {
+    return {};
+  }
+
+  LOGT("Embedded thumbnail of " << path << " fits");
+
+  return to_qimage(thumb);
+}
+
+QImage BarchImageProvider::decode_barch(barchclib0::IBarchImagePtr img,
+                                        const QSize &requestedSize)
+{
+  const size_t scale =
+      fitting_scale(img->width(), img->height(), requestedSize);
+
+  if (scale > 1U) {
+    return to_qimage(mdecoder->barch_to_thumbnail(img, scale));
+  }
+
+  QImage image(static_cast<int>(img->width()), static_cast<int>(img->height()),
+               QImage::Format_Grayscale8);
+
+  if (image.isNull()) {
+    LOGE("Fail to allocate the " << img->width() << "x" << img->height()
+                                 << " image");
+    return {};
+  }
+
+  // Straight into the QImage rows, no intermediate BMP
+  const barchclib0::DecodeTarget target{
+      image.bits(), static_cast<size_t>(image.sizeInBytes()),
+      static_cast<size_t>(image.bytesPerLine()),
+      barchclib0::RowOrder::top_down};
+
+  if (!mdecoder->barch_to_buffer(img, target)) {
+    return {};
+  }
+
+  return image;
+}
+
+QImage BarchImageProvider::fit_requested(const QImage &image,
+                                         const QSize &requestedSize)
+{
+  if (image.isNull() ||
+      (requestedSize.width() <= 0 && requestedSize.height() <= 0)) {
+    return image;
+  }
+
+  // The zero side of the source size is unconstrained
+  const QSize bound{
+      requestedSize.width() > 0 ? requestedSize.width() : image.width(),
+      requestedSize.height() > 0 ? requestedSize.height() : image.height()};
+
+  if (image.width() <= bound.width() && image.height() <= bound.height()) {
+    return image;
+  }
+
+  return image.scaled(bound, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+size_t BarchImageProvider::fitting_scale(const size_t &width,
+                                         const size_t &height,
+                                         const QSize &requestedSize)
+{
+  if (requestedSize.width() <= 0 && requestedSize.height() <= 0) {
+    return 1U;
+  }
+
+  // The zero side of the source size is unconstrained
+  const auto rwidth = static_cast<size_t>(std::max(0, requestedSize.width()));
+  const auto rheight =
+      static_cast<size_t>(std::max(0, requestedSize.height()));
+
+  for (const size_t scale : {8U, 4U, 2U}) {
+    if ((width + scale - 1U) / scale >= rwidth &&
+        (height + scale - 1U) / scale >= rheight) {
+      return scale;
+    }
+  }
+
+  return 1U;
+}
+
+QImage BarchImageProvider::to_qimage(barchclib0::IBarchImagePtr img)
+{
+  if (img == nullptr) {
+    return {};
+  }
+
+  const size_t width = img->width();
+  const size_t height = img->height();
+  const barchclib0::barchdata &pixels = img->data();
+
+  if (width == 0U || height == 0U || pixels.size() < width * height) {
+    LOGE("Invalid image " << width << "x" << height << " of "
+                          << pixels.size() << " pixels");
+    return {};
+  }
+
+  QImage image(static_cast<int>(width), static_cast<int>(height),
+               QImage::Format_Grayscale8);
+
+  if (image.isNull()) {
+    LOGE("Fail to allocate the " << width << "x" << height << " image");
+    return {};
+  }
+
+  // The QImage rows are 4 bytes aligned
+  for (size_t row = 0U; row < height; ++row) {
+    std::memcpy(image.scanLine(static_cast<int>(row)),
+                pixels.data() + row * width, width);
+  }
+
+  return image;
+}
+
+bool BarchImageProvider::is_bmp(const std::filesystem::path &gpath)
+{
+  static const std::string bmpe = ".bmp";
+
+  return gpath.extension().string() == bmpe;
+}
+
+bool BarchImageProvider::is_barch(const std::filesystem::path &gpath)
+{
+  static const std::string barche = ".barch";
+  static const std::string bae = ".ba";
+
+  return gpath.extension().string() == barche ||
+         gpath.extension().string() == bae;
+}
+
+}  // namespace Qt6i::providers
@@ -0,0 +1,115 @@
+#ifndef THE_BMP_2_BARCH_CODER_PROJECT_BARCHIMAGEPROVIDER_CLASS_H
+#define THE_BMP_2_BARCH_CODER_PROJECT_BARCHIMAGEPROVIDER_CLASS_H
+
+#include <QImage>
+#include <QQuickAsyncImageProvider>
+#include <QQuickImageResponse>
+#include <QSize>
+#include <QString>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "LibraryFacade.h"
+#include "src/qt6/providers/ImageLruCache.h"
+
+namespace Qt6i::providers
+{
+
+/**
+ * @brief The response of a single image request. Finished once from any
+ * thread, the finished signal is delivered to the requesting thread.
+ */
+class BarchImageResponse : public QQuickImageResponse
+{
+  Q_OBJECT
+ public:
+  virtual ~BarchImageResponse() = default;
+  BarchImageResponse() = default;
+
+  QQuickTextureFactory *textureFactory() const override;
+  QString errorString() const override;
+
+  /// @brief Delivers the image, the null one with the error description
+  void complete(const QImage &image, const QString &error = {});
+
+ private:
+  QImage mimage;
+  QString merror;
+};
+
+/**
+ * @brief Serves the barch and BMP files to the QML image views without the
+ * BMP written to the disk: image://barch/<percent encoded file path>.
+ *
+ * The files are read and decoded on the library executor. With the source
+ * size set the barch files are decoded at the 1/2, 1/4 or 1/8 scale the
+ * size still fits, the small previews are taken from the embedded file
+ * thumbnail when it is large enough. The BMP files, the decodings and the
+ * previews are then scaled down to the source size. The served images are
+ * kept in the LRU cache up to the cache_bytes.
+ */
+class BarchImageProvider : public QQuickAsyncImageProvider
+{
+ public:
+  /// @brief Waits the decodings in progress
+  virtual ~BarchImageProvider();
+  explicit BarchImageProvider(const size_t &cache_bytes = default_cache_bytes);
+
+  QQuickImageResponse *requestImageResponse(
+      const QString &id, const QSize &requestedSize) override;
+
+  inline static constexpr const char *const provider_id = "barch";
+  inline static constexpr const size_t default_cache_bytes = 64U << 20U;
+
+ private:
+  /// @brief The read stage is done: decodes the image at the fitting scale
+  void on_read(BarchImageResponse *response, const QString &key,
+               const std::filesystem::path &path, const QSize &requestedSize,
+               barchclib0::IBarchImagePtr img);
+
+  /// @brief Publishes the result, caches the image and releases the request
+  void finish(BarchImageResponse *response, const QString &key,
+              const QImage &image, const QString &error);
+
+  /// @brief The embedded thumbnail, if any, that covers the requested size
+  QImage embedded_thumbnail(const std::filesystem::path &path,
+                            const QSize &requestedSize);
+
+  /// @brief Decodes the barch image at the largest scale covering the size
+  QImage decode_barch(barchclib0::IBarchImagePtr img,
+                      const QSize &requestedSize);
+
+  /**
+   * @brief The image scaled down to fit the source size, so the cache keeps
+   * the small previews rather than the large decodings
+   */
+  static QImage fit_requested(const QImage &image, const QSize &requestedSize);
+
+  /// @brief The largest thumbnail scale the image still covers the size at
+  static size_t fitting_scale(const size_t &width, const size_t &height,
+                              const QSize &requestedSize);
+
+  /// @brief Copies the grayscale pixels into the QImage
+  static QImage to_qimage(barchclib0::IBarchImagePtr img);
+
+  static bool is_bmp(const std::filesystem::path &gpath);
+  static bool is_barch(const std::filesystem::path &gpath);
+
+  ImageLruCache mcache;
+
+  barchclib0::LibraryFacade cfactory;
+
+  // The reads and the decodings run on the library executor
+  barchclib0::ILibPtr mdecoder;
+
+  std::mutex mpendingm;
+  std::condition_variable mpendingcv;
+  size_t mpending{0U};
+};
+
+}  // namespace Qt6i::providers
+
+#endif  // THE_BMP_2_BARCH_CODER_PROJECT_BARCHIMAGEPROVIDER_CLASS_H
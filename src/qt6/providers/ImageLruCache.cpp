@@ -0,0 +1,85 @@
+#include "src/qt6/providers/ImageLruCache.h"
+
+#include <QImage>
+#include <QString>
+#include <cstddef>
+#include <mutex>
+
+#include "src/log/log.h"
+
+namespace Qt6i::providers
+{
+
+ImageLruCache::ImageLruCache(const size_t& capacity) : mcapacity{capacity} {}
+
+QImage ImageLruCache::find(const QString& key)
+{
+  std::lock_guard<std::mutex> guard{mmutex};
+
+  const auto found = mindex.find(key);
+
+  if (found == mindex.end()) {
+    return {};
+  }
+
+  mentries.splice(mentries.begin(), mentries, found->second);
+
+  return found->second->second;
+}
+
+void ImageLruCache::insert(const QString& key, const QImage& image)
+{
+  const auto size = static_cast<size_t>(image.sizeInBytes());
+
+  if (image.isNull() || size > mcapacity) {
+    LOGD("Not caching the image of " << size << " bytes");
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard{mmutex};
+
+  const auto found = mindex.find(key);
+
+  if (found != mindex.end()) {
+    mbytes -= static_cast<size_t>(found->second->second.sizeInBytes());
+    mentries.erase(found->second);
+    mindex.erase(found);
+  }
+
+  mentries.emplace_front(key, image);
+  mindex.emplace(key, mentries.begin());
+  mbytes += size;
+
+  evict();
+}
+
+void ImageLruCache::clear()
+{
+  std::lock_guard<std::mutex> guard{mmutex};
+
+  mentries.clear();
+  mindex.clear();
+  mbytes = 0U;
+}
+
+size_t ImageLruCache::bytes() const
+{
+  std::lock_guard<std::mutex> guard{mmutex};
+
+  return mbytes;
+}
+
+const size_t& ImageLruCache::capacity() const { return mcapacity; }
+
+void ImageLruCache::evict()
+{
+  while (mbytes > mcapacity && !mentries.empty()) {
+    const entry& last = mentries.back();
+
+    mbytes -= static_cast<size_t>(last.second.sizeInBytes());
+    mindex.erase(last.first);
+    mentries.pop_back();
+  }
+}
+
+}  // namespace Qt6i::providers
@@ -0,0 +1,55 @@
+#ifndef THE_BMP_2_BARCH_CODER_PROJECT_IMAGELRUCACHE_CLASS_H
+#define THE_BMP_2_BARCH_CODER_PROJECT_IMAGELRUCACHE_CLASS_H
+
+#include <QImage>
+#include <QString>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Qt6i::providers
+{
+
+/**
+ * @brief The decoded images cache bounded by the pixel bytes. The least
+ * recently used images are dropped first. Safe to use from any thread.
+ */
+class ImageLruCache
+{
+ public:
+  virtual ~ImageLruCache() = default;
+  explicit ImageLruCache(const size_t& capacity);
+
+  /// @brief The cached image of the key or the null image, marks it used
+  QImage find(const QString& key);
+
+  /// @brief Caches the image, the images larger than the capacity are not
+  void insert(const QString& key, const QImage& image);
+
+  void clear();
+
+  size_t bytes() const;
+  const size_t& capacity() const;
+
+ private:
+  using entry = std::pair<QString, QImage>;
+  using entries = std::list<entry>;
+
+  /// @brief Drops the least recently used images down to the capacity
+  void evict();
+
+  const size_t mcapacity;
+  size_t mbytes{0U};
+
+  // The most recently used images go first
+  entries mentries;
+  std::unordered_map<QString, entries::iterator> mindex;
+
+  mutable std::mutex mmutex;
+};
+
+}  // namespace Qt6i::providers
+
+#endif  // THE_BMP_2_BARCH_CODER_PROJECT_IMAGELRUCACHE_CLASS_H
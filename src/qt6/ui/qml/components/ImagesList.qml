@@ -4,6 +4,11 @@ import QtQuick.Layouts
 
 Item {
   readonly property color colorBorder: "#777"
+  readonly property int thumbnailSide: 48
+  
+  function image_source(filePath) {
+    return "image://barch/" + encodeURIComponent(filePath)
+  }
   
   anchors.fill: parent
     
@@ -20,41 +25,76 @@ Item {
       text: "Список файлів для перетворення. Для перетворення необхідно клікнути по рядку файлу."
     }
     
-    ListView {
-      id: listView
-      
+    RowLayout {
       Layout.fillWidth: true
       Layout.fillHeight: true
       
-      property int selectedIndex: -1
+      ListView {
+        id: listView
+      
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+      
+        property int selectedIndex: -1
+        property string selectedPath: ""
 
-      model: ImagesFilesListProvider
-      clip: true
+        model: ImagesFilesListProvider
+        clip: true
       
-      delegate: Rectangle {
-        id: delRoot
+        delegate: Rectangle {
+          id: delRoot
         
-        width: parent.width
-        height: fileDisplay.height
+          width: parent.width
+          height: Math.max(fileDisplay.height, thumbnail.height)
         
-        border.color: colorBorder
+          border.color: colorBorder
         
-        Text {
-          id: fileDisplay
-          anchors.top: parent.top
-          anchors.left: parent.left
+          Image {
+            id: thumbnail
+            anchors.top: parent.top
+            anchors.left: parent.left
           
-          text: path + " [" + size + "]" + (current_operation != "" ? " [" +current_operation + "]" : "" )
-        }
+            width: thumbnailSide
+            height: thumbnailSide
+          
+            asynchronous: true
+            cache: false
+            fillMode: Image.PreserveAspectFit
+            sourceSize.height: thumbnailSide
+            source: image_source(path)
+          }
         
-        MouseArea {
-          anchors.fill: parent
-          onClicked: { 
-            listView.model.convert_file(index)
-            listView.selectedIndex = index
+          Text {
+            id: fileDisplay
+            anchors.top: parent.top
+            anchors.left: thumbnail.right
+            anchors.leftMargin: 4
+          
+            text: path + " [" + size + "]" + (current_operation != "" ? " [" +current_operation + "]" : "" )
+          }
+        
+          MouseArea {
+            anchors.fill: parent
+            onClicked: { 
+              listView.model.convert_file(index)
+              listView.selectedIndex = index
+              listView.selectedPath = path
+            }
           }
         }
+      } // listview
+    
+      Image {
+        id: preview
+      
+        Layout.fillHeight: true
+        Layout.preferredWidth: parent.width / 3
+      
+        asynchronous: true
+        cache: false
+        fillMode: Image.PreserveAspectFit
+        source: listView.selectedPath != "" ? image_source(listView.selectedPath) : ""
       }
-    } // listview
+    } // row
   } // column
 } // item
@@ -30,9 +30,50 @@ class LibMain : public barchclib0::ILib
 
   MOCK_METHOD(IBarchImagePtr, bmp_to_barch, (IBarchImagePtr bmp), (override));
   MOCK_METHOD(IBarchImagePtr, barch_to_bmp, (IBarchImagePtr barch), (override));
+  MOCK_METHOD(bool, barch_to_buffer,
+              (IBarchImagePtr barch, const barchclib0::DecodeTarget& target),
+              (override));
+  MOCK_METHOD(bool, barch_to_buffer,
+              (IBarchImagePtr barch, const barchclib0::DecodeTarget& target,
+               const barchclib0::DecodeRegion& region),
+              (override));
+  MOCK_METHOD(IBarchImagePtr, barch_to_thumbnail,
+              (IBarchImagePtr barch, const size_t& scale), (override));
+  MOCK_METHOD(IBarchImagePtr, read_thumbnail,
+              (const std::filesystem::path& imagePath), (override));
   MOCK_METHOD(IBarchImagePtr, read, (const std::filesystem::path& imagePath),
               (override));
   MOCK_METHOD(bool, write, (IBarchImagePtr barch), (override));
+  MOCK_METHOD(barchclib0::BatchResults, convert_batch,
+              (const barchclib0::BatchItems& items,
+               const barchclib0::BatchOptions& options),
+              (override));
+  MOCK_METHOD(std::future<IBarchImagePtr>, read_async,
+              (const std::filesystem::path& imagePath), (override));
+  MOCK_METHOD(void, read_async,
+              (const std::filesystem::path& imagePath, ImageCallback done),
+              (override));
+  MOCK_METHOD(std::future<IBarchImagePtr>, bmp_to_barch_async,
+              (IBarchImagePtr bmp), (override));
+  MOCK_METHOD(void, bmp_to_barch_async,
+              (IBarchImagePtr bmp, ImageCallback done), (override));
+  MOCK_METHOD(std::future<IBarchImagePtr>, barch_to_bmp_async,
+              (IBarchImagePtr barch), (override));
+  MOCK_METHOD(void, barch_to_bmp_async,
+              (IBarchImagePtr barch, ImageCallback done), (override));
+  MOCK_METHOD(std::future<bool>, write_async, (IBarchImagePtr image),
+              (override));
+  MOCK_METHOD(void, write_async, (IBarchImagePtr image, WriteCallback done),
+              (override));
+  MOCK_METHOD(void, executor_threads, (const size_t& threads), (override));
+  MOCK_METHOD(void, barch_format, (const barchclib0::BarchFormat& nformat),
+              (override));
+  MOCK_METHOD(void, quantization,
+              (const barchclib0::Quantization& nquantization), (override));
+  MOCK_METHOD(void, encoder_preset, (const barchclib0::EncoderPreset& npreset),
+              (override));
+  MOCK_METHOD(void, decode_threads, (const size_t& threads), (override));
+  MOCK_METHOD(void, thumbnail_side, (const size_t& side), (override));
   MOCK_METHOD(ILibPtr, duplicate, (), (override));
   MOCK_METHOD(IBarchImagePtr, create_empty_bmp, (), (override));
 
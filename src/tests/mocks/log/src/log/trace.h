@@ -0,0 +1,24 @@
+#ifndef YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H
+#define YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H
+
+#include <gmock/gmock.h>
+
+class traceMock
+{
+ public:
+  inline static testing::MockFunction<void(const std::string& filepath)>
+      TRACE_INIT;
+  inline static testing::MockFunction<bool()> TRACE_FLUSH;
+  inline static testing::MockFunction<void(const std::string& name)>
+      TRACE_THREAD_NAME;
+};
+
+#define TRACE_INIT(filepath) traceMock::TRACE_INIT.AsStdFunction()(filepath);
+#define TRACE_FLUSH() traceMock::TRACE_FLUSH.AsStdFunction()()
+#define TRACE_THREAD_NAME(name) \
+  traceMock::TRACE_THREAD_NAME.AsStdFunction()(name);
+
+#define TRACE_SPAN(category, name)
+#define TRACE_SPAN_FILE(category, name, filepath)
+
+#endif  // YOUR_CPP_APP_TEMPLATE_PROJECT_TRACER_SUBSYSTEM_DECLARATIONS_H